@@ -0,0 +1,474 @@
+#include "bundle_adjustment.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+
+namespace YACCP::Calibration {
+    namespace {
+        using CamBlock = cv::Matx<double, camParams, camParams>;
+        using CamFrameBlock = cv::Matx<double, camParams, poseParams>;
+
+        struct NormalEquations {
+            // Per camera.
+            std::vector<CamBlock> u;
+            std::vector<CamVec> gCam;
+            // Per frame.
+            std::vector<cv::Matx66d> v;
+            std::vector<cv::Vec6d> gFrame;
+            // Per observation, couples the camera with the frame of that observation.
+            std::vector<CamFrameBlock> w;
+            double cost{};
+        };
+
+
+        // Split [0, count) in one chunk per thread, so every chunk can keep its own accumulators.
+        template <typename Body>
+        void forEachChunk(const int count, Body body) {
+            const int chunks{std::max(1, std::min(cv::getNumThreads(), count))};
+            cv::parallel_for_(cv::Range(0, chunks),
+                              [&](const cv::Range& range) {
+                                  for (auto chunk{range.start}; chunk < range.end; ++chunk) {
+                                      body(chunk, count * chunk / chunks, count * (chunk + 1) / chunks);
+                                  }
+                              },
+                              chunks);
+        }
+
+
+        int chunkCount(const int count) {
+            return std::max(1, std::min(cv::getNumThreads(), count));
+        }
+
+
+        cv::Matx33d rodrigues(const cv::Vec3d& r) {
+            const double theta{cv::norm(r)};
+            const cv::Matx33d skew{0., -r[2], r[1], r[2], 0., -r[0], -r[1], r[0], 0.};
+            if (theta < 1e-12) return cv::Matx33d::eye() + skew;
+
+            const cv::Matx33d k{skew * (1. / theta)};
+            return cv::Matx33d::eye() + std::sin(theta) * k + (1. - std::cos(theta)) * (k * k);
+        }
+
+
+        void projectObservation(const CamVec& cam,
+                                const cv::Vec6d& frame,
+                                const RigObservation& observation,
+                                std::vector<cv::Vec2d>& projected) {
+            const cv::Matx33d frameR{rodrigues(cv::Vec3d(frame[0], frame[1], frame[2]))};
+            const cv::Vec3d frameT{frame[3], frame[4], frame[5]};
+            const cv::Matx33d camR{rodrigues(cv::Vec3d(cam[9], cam[10], cam[11]))};
+            const cv::Vec3d camT{cam[12], cam[13], cam[14]};
+
+            // Board to camera.
+            const cv::Matx33d r{camR * frameR};
+            const cv::Vec3d t{camR * frameT + camT};
+
+            projected.resize(observation.objPoints.size());
+            for (std::size_t i{0}; i < observation.objPoints.size(); ++i) {
+                const auto& objPoint{observation.objPoints[i]};
+                const cv::Vec3d p{r * cv::Vec3d(objPoint.x, objPoint.y, objPoint.z) + t};
+                const double x{p[0] / p[2]};
+                const double y{p[1] / p[2]};
+                const double r2{x * x + y * y};
+                const double radial{1. + cam[4] * r2 + cam[5] * r2 * r2 + cam[8] * r2 * r2 * r2};
+                const double xd{x * radial + 2. * cam[6] * x * y + cam[7] * (r2 + 2. * x * x)};
+                const double yd{y * radial + cam[6] * (r2 + 2. * y * y) + 2. * cam[7] * x * y};
+                projected[i] = {cam[0] * xd + cam[2], cam[1] * yd + cam[3]};
+            }
+        }
+
+
+        // Derivatives of a rotation matrix to each component of its rotation vector.
+        std::array<cv::Matx33d, 3> rotationDerivatives(const cv::Vec3d& r, cv::Matx33d& rotation) {
+            cv::Matx<double, 3, 9> jacobian;
+            cv::Rodrigues(r, rotation, jacobian);
+
+            std::array<cv::Matx33d, 3> derivatives;
+            for (auto k{0}; k < 3; ++k) {
+                for (auto e{0}; e < 9; ++e) derivatives[k](e / 3, e % 3) = jacobian(k, e);
+            }
+            return derivatives;
+        }
+
+
+        /**
+         * @brief Project an observation and evaluate the analytic Jacobians of every projected corner.
+         *
+         * Uses the same five coefficient distortion model as OpenCV, so the cost matches cv::calibrateCamera.
+         */
+        void projectWithJacobian(const CamVec& cam,
+                                 const cv::Vec6d& frame,
+                                 const RigObservation& observation,
+                                 std::vector<cv::Vec2d>& projected,
+                                 std::array<std::vector<cv::Vec2d>, camParams>& jacCam,
+                                 std::array<std::vector<cv::Vec2d>, poseParams>& jacFrame) {
+            cv::Matx33d frameR;
+            cv::Matx33d camR;
+            const auto frameDerivatives{rotationDerivatives(cv::Vec3d(frame[0], frame[1], frame[2]), frameR)};
+            const auto camDerivatives{rotationDerivatives(cv::Vec3d(cam[9], cam[10], cam[11]), camR)};
+            const cv::Vec3d frameT{frame[3], frame[4], frame[5]};
+            const cv::Vec3d camT{cam[12], cam[13], cam[14]};
+            const double fx{cam[0]};
+            const double fy{cam[1]};
+            const double k1{cam[4]};
+            const double k2{cam[5]};
+            const double p1{cam[6]};
+            const double p2{cam[7]};
+            const double k3{cam[8]};
+
+            const std::size_t n{observation.objPoints.size()};
+            projected.resize(n);
+            for (auto& column : jacCam) column.resize(n);
+            for (auto& column : jacFrame) column.resize(n);
+
+            for (std::size_t i{0}; i < n; ++i) {
+                const auto& objPoint{observation.objPoints[i]};
+                const cv::Vec3d boardPoint{objPoint.x, objPoint.y, objPoint.z};
+                const cv::Vec3d refPoint{frameR * boardPoint + frameT};
+                const cv::Vec3d p{camR * refPoint + camT};
+
+                const double invZ{1. / p[2]};
+                const double x{p[0] * invZ};
+                const double y{p[1] * invZ};
+                const double r2{x * x + y * y};
+                const double r4{r2 * r2};
+                const double r6{r4 * r2};
+                const double radial{1. + k1 * r2 + k2 * r4 + k3 * r6};
+                const double xd{x * radial + 2. * p1 * x * y + p2 * (r2 + 2. * x * x)};
+                const double yd{y * radial + p1 * (r2 + 2. * y * y) + 2. * p2 * x * y};
+                projected[i] = {fx * xd + cam[2], fy * yd + cam[3]};
+
+                // fx, fy, cx, cy, k1, k2, p1, p2, k3
+                jacCam[0][i] = {xd, 0.};
+                jacCam[1][i] = {0., yd};
+                jacCam[2][i] = {1., 0.};
+                jacCam[3][i] = {0., 1.};
+                jacCam[4][i] = {fx * x * r2, fy * y * r2};
+                jacCam[5][i] = {fx * x * r4, fy * y * r4};
+                jacCam[6][i] = {fx * 2. * x * y, fy * (r2 + 2. * y * y)};
+                jacCam[7][i] = {fx * (r2 + 2. * x * x), fy * 2. * x * y};
+                jacCam[8][i] = {fx * x * r6, fy * y * r6};
+
+                // Pixel to camera coordinates, through the distortion and the perspective division.
+                const double dRadial{k1 + 2. * k2 * r2 + 3. * k3 * r4};
+                const double dxdx{radial + 2. * x * x * dRadial + 2. * p1 * y + 6. * p2 * x};
+                const double dxdy{2. * x * y * dRadial + 2. * p1 * x + 2. * p2 * y};
+                const double dydx{2. * x * y * dRadial + 2. * p1 * x + 2. * p2 * y};
+                const double dydy{radial + 2. * y * y * dRadial + 6. * p1 * y + 2. * p2 * x};
+                const cv::Matx23d dPixel{
+                    fx * dxdx * invZ, fx * dxdy * invZ, -fx * (dxdx * x + dxdy * y) * invZ,
+                    fy * dydx * invZ, fy * dydy * invZ, -fy * (dydx * x + dydy * y) * invZ
+                };
+                const cv::Matx23d dPixelRef{dPixel * camR};
+
+                for (auto k{0}; k < 3; ++k) {
+                    jacCam[intrinsicParams + k][i] = dPixel * (camDerivatives[k] * refPoint);
+                    jacCam[intrinsicParams + 3 + k][i] = {dPixel(0, k), dPixel(1, k)};
+                    jacFrame[k][i] = dPixelRef * (frameDerivatives[k] * boardPoint);
+                    jacFrame[3 + k][i] = {dPixelRef(0, k), dPixelRef(1, k)};
+                }
+            }
+        }
+
+
+        double evaluateCost(const std::vector<RigObservation>& observations,
+                            const RigParameters& params,
+                            std::vector<double>& camCost,
+                            std::vector<int>& camPoints) {
+            const int numObservations{static_cast<int>(observations.size())};
+            const int chunks{chunkCount(numObservations)};
+            std::vector<std::vector<double> > chunkCost(chunks, std::vector<double>(params.cams.size()));
+            std::vector<std::vector<int> > chunkPoints(chunks, std::vector<int>(params.cams.size()));
+
+            forEachChunk(numObservations,
+                         [&](const int chunk, const int begin, const int end) {
+                             std::vector<cv::Vec2d> projected;
+                             for (auto o{begin}; o < end; ++o) {
+                                 const auto& observation{observations[o]};
+                                 projectObservation(params.cams[observation.camId],
+                                                    params.frames[observation.frameId],
+                                                    observation,
+                                                    projected);
+                                 for (std::size_t i{0}; i < projected.size(); ++i) {
+                                     const cv::Vec2d residual{
+                                         projected[i] - cv::Vec2d(observation.imgPoints[i].x,
+                                                                  observation.imgPoints[i].y)
+                                     };
+                                     chunkCost[chunk][observation.camId] += residual.dot(residual);
+                                 }
+                                 chunkPoints[chunk][observation.camId] += static_cast<int>(projected.size());
+                             }
+                         });
+
+            camCost.assign(params.cams.size(), 0.);
+            camPoints.assign(params.cams.size(), 0);
+            double cost{};
+            for (auto chunk{0}; chunk < chunks; ++chunk) {
+                for (std::size_t c{0}; c < params.cams.size(); ++c) {
+                    camCost[c] += chunkCost[chunk][c];
+                    camPoints[c] += chunkPoints[chunk][c];
+                    cost += chunkCost[chunk][c];
+                }
+            }
+
+            return cost;
+        }
+
+
+        void buildNormalEquations(const std::vector<RigObservation>& observations,
+                                  const std::vector<std::vector<int> >& frameObservations,
+                                  const RigParameters& params,
+                                  const std::vector<bool>& fixed,
+                                  NormalEquations& eq) {
+            const int numCams{static_cast<int>(params.cams.size())};
+            const int numFrames{static_cast<int>(params.frames.size())};
+            const int chunks{chunkCount(numFrames)};
+
+            // The camera blocks are shared between frames, every chunk accumulates into its own copy.
+            std::vector<std::vector<CamBlock> > chunkU(chunks, std::vector<CamBlock>(numCams, CamBlock::zeros()));
+            std::vector<std::vector<CamVec> > chunkG(chunks, std::vector<CamVec>(numCams, CamVec::zeros()));
+            std::vector<double> chunkCost(chunks);
+
+            eq.v.assign(numFrames, cv::Matx66d::zeros());
+            eq.gFrame.assign(numFrames, cv::Vec6d::zeros());
+            eq.w.assign(observations.size(), CamFrameBlock::zeros());
+
+            forEachChunk(numFrames,
+                         [&](const int chunk, const int begin, const int end) {
+                             std::vector<cv::Vec2d> projected;
+                             std::vector<cv::Vec2d> residuals;
+                             std::array<std::vector<cv::Vec2d>, camParams> jacCam;
+                             std::array<std::vector<cv::Vec2d>, poseParams> jacFrame;
+
+                             for (auto f{begin}; f < end; ++f) {
+                                 for (const int o : frameObservations[f]) {
+                                     const auto& observation{observations[o]};
+                                     const int c{observation.camId};
+                                     const CamVec& cam{params.cams[c]};
+                                     const cv::Vec6d& frame{params.frames[f]};
+                                     const std::size_t n{observation.objPoints.size()};
+
+                                     projectWithJacobian(cam, frame, observation, projected, jacCam, jacFrame);
+                                     residuals.resize(n);
+                                     for (std::size_t i{0}; i < n; ++i) {
+                                         residuals[i] = projected[i] - cv::Vec2d(observation.imgPoints[i].x,
+                                                                                 observation.imgPoints[i].y);
+                                     }
+
+                                     // Fixed parameters get a zero column.
+                                     for (auto k{0}; k < camParams; ++k) {
+                                         if (fixed[c * camParams + k]) jacCam[k].assign(n, cv::Vec2d::zeros());
+                                     }
+
+                                     CamBlock& u{chunkU[chunk][c]};
+                                     CamVec& gCam{chunkG[chunk][c]};
+                                     cv::Matx66d& v{eq.v[f]};
+                                     cv::Vec6d& gFrame{eq.gFrame[f]};
+                                     CamFrameBlock& w{eq.w[o]};
+
+                                     for (std::size_t i{0}; i < n; ++i) {
+                                         const cv::Vec2d& r{residuals[i]};
+                                         chunkCost[chunk] += r.dot(r);
+
+                                         for (auto a{0}; a < camParams; ++a) {
+                                             const cv::Vec2d& ja{jacCam[a][i]};
+                                             gCam[a] += ja.dot(r);
+                                             for (auto b{a}; b < camParams; ++b) u(a, b) += ja.dot(jacCam[b][i]);
+                                             for (auto b{0}; b < poseParams; ++b) w(a, b) += ja.dot(jacFrame[b][i]);
+                                         }
+                                         for (auto a{0}; a < poseParams; ++a) {
+                                             const cv::Vec2d& ja{jacFrame[a][i]};
+                                             gFrame[a] += ja.dot(r);
+                                             for (auto b{a}; b < poseParams; ++b) v(a, b) += ja.dot(jacFrame[b][i]);
+                                         }
+                                     }
+                                 }
+
+                                 // Only the upper triangle was accumulated.
+                                 for (auto a{0}; a < poseParams; ++a) {
+                                     for (auto b{0}; b < a; ++b) eq.v[f](a, b) = eq.v[f](b, a);
+                                 }
+                             }
+                         });
+
+            eq.u.assign(numCams, CamBlock::zeros());
+            eq.gCam.assign(numCams, CamVec::zeros());
+            eq.cost = 0.;
+            for (auto chunk{0}; chunk < chunks; ++chunk) {
+                for (auto c{0}; c < numCams; ++c) {
+                    eq.u[c] += chunkU[chunk][c];
+                    eq.gCam[c] += chunkG[chunk][c];
+                }
+                eq.cost += chunkCost[chunk];
+            }
+            for (auto& u : eq.u) {
+                for (auto a{0}; a < camParams; ++a) {
+                    for (auto b{0}; b < a; ++b) u(a, b) = u(b, a);
+                }
+            }
+        }
+
+
+        bool solveStep(const std::vector<RigObservation>& observations,
+                       const std::vector<std::vector<int> >& frameObservations,
+                       const NormalEquations& eq,
+                       const std::vector<bool>& fixed,
+                       const double lambda,
+                       std::vector<CamVec>& deltaCams,
+                       std::vector<cv::Vec6d>& deltaFrames) {
+            const int numCams{static_cast<int>(eq.u.size())};
+            const int numFrames{static_cast<int>(eq.v.size())};
+            const int n{numCams * camParams};
+
+            // Reduced camera system: (U - W V^-1 W^T) dc = -gc + W V^-1 gf.
+            cv::Mat s{cv::Mat::zeros(n, n, CV_64F)};
+            cv::Mat rhs{cv::Mat::zeros(n, 1, CV_64F)};
+
+            for (auto c{0}; c < numCams; ++c) {
+                for (auto a{0}; a < camParams; ++a) {
+                    for (auto b{0}; b < camParams; ++b) {
+                        s.at<double>(c * camParams + a, c * camParams + b) = eq.u[c](a, b);
+                    }
+                    s.at<double>(c * camParams + a, c * camParams + a) += lambda * std::max(eq.u[c](a, a), 1e-9);
+                    rhs.at<double>(c * camParams + a) = -eq.gCam[c][a];
+                }
+            }
+
+            std::vector<cv::Matx66d> vInvs(numFrames);
+            for (auto f{0}; f < numFrames; ++f) {
+                cv::Matx66d v{eq.v[f]};
+                for (auto a{0}; a < poseParams; ++a) v(a, a) += lambda * std::max(v(a, a), 1e-9);
+
+                bool isOk{false};
+                vInvs[f] = v.inv(cv::DECOMP_CHOLESKY, &isOk);
+                if (!isOk) return false;
+
+                for (const int oa : frameObservations[f]) {
+                    const int ca{observations[oa].camId};
+                    const CamFrameBlock y{eq.w[oa] * vInvs[f]};
+                    const CamVec yg{y * eq.gFrame[f]};
+                    for (auto a{0}; a < camParams; ++a) rhs.at<double>(ca * camParams + a) += yg[a];
+
+                    for (const int ob : frameObservations[f]) {
+                        const int cb{observations[ob].camId};
+                        const CamBlock ywt{y * eq.w[ob].t()};
+                        for (auto a{0}; a < camParams; ++a) {
+                            for (auto b{0}; b < camParams; ++b) {
+                                s.at<double>(ca * camParams + a, cb * camParams + b) -= ywt(a, b);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Fixed parameters are removed from the system by forcing their update to zero.
+            for (auto i{0}; i < n; ++i) {
+                if (!fixed[i]) continue;
+                s.row(i).setTo(cv::Scalar{0.});
+                s.col(i).setTo(cv::Scalar{0.});
+                s.at<double>(i, i) = 1.;
+                rhs.at<double>(i) = 0.;
+            }
+
+            cv::Mat delta;
+            if (!cv::solve(s, rhs, delta, cv::DECOMP_CHOLESKY)) return false;
+
+            deltaCams.assign(numCams, CamVec::zeros());
+            for (auto c{0}; c < numCams; ++c) {
+                for (auto a{0}; a < camParams; ++a) deltaCams[c][a] = delta.at<double>(c * camParams + a);
+            }
+
+            // Back-substitute the frame updates: df = V^-1 (-gf - W^T dc).
+            deltaFrames.assign(numFrames, cv::Vec6d::zeros());
+            for (auto f{0}; f < numFrames; ++f) {
+                cv::Vec6d b{-eq.gFrame[f]};
+                for (const int o : frameObservations[f]) {
+                    b -= eq.w[o].t() * deltaCams[observations[o].camId];
+                }
+                deltaFrames[f] = vInvs[f] * b;
+            }
+
+            return true;
+        }
+    }
+
+
+    BundleAdjustmentResult bundleAdjust(const std::vector<RigObservation>& observations,
+                                        RigParameters& params,
+                                        const BundleAdjustmentOptions& options) {
+        const int numCams{static_cast<int>(params.cams.size())};
+        const int numFrames{static_cast<int>(params.frames.size())};
+        BundleAdjustmentResult result;
+
+        std::vector<std::vector<int> > frameObservations(numFrames);
+        for (auto o{0}; o < static_cast<int>(observations.size()); ++o) {
+            frameObservations[observations[o].frameId].emplace_back(o);
+        }
+
+        // The reference camera defines the rig frame, fixing its pose removes the gauge freedom.
+        std::vector<bool> fixed(numCams * camParams, false);
+        for (auto k{intrinsicParams}; k < camParams; ++k) fixed[options.referenceCam * camParams + k] = true;
+        if (options.fixIntrinsics) {
+            for (auto c{0}; c < numCams; ++c) {
+                for (auto k{0}; k < intrinsicParams; ++k) fixed[c * camParams + k] = true;
+            }
+        }
+
+        NormalEquations eq;
+        buildNormalEquations(observations, frameObservations, params, fixed, eq);
+
+        double lambda{1e-3};
+        std::vector<CamVec> deltaCams;
+        std::vector<cv::Vec6d> deltaFrames;
+        std::vector<double> camCost;
+        std::vector<int> camPoints;
+
+        for (auto iteration{0}; iteration < options.maxIterations; ++iteration) {
+            RigParameters candidate;
+            double candidateCost{};
+            bool improved{false};
+
+            // Increase the damping until a step lowers the cost.
+            while (lambda < 1e16) {
+                if (solveStep(observations, frameObservations, eq, fixed, lambda, deltaCams, deltaFrames)) {
+                    candidate = params;
+                    for (auto c{0}; c < numCams; ++c) candidate.cams[c] += deltaCams[c];
+                    for (auto f{0}; f < numFrames; ++f) candidate.frames[f] += deltaFrames[f];
+
+                    candidateCost = evaluateCost(observations, candidate, camCost, camPoints);
+                    if (candidateCost < eq.cost) {
+                        improved = true;
+                        break;
+                    }
+                }
+                lambda *= 10.;
+            }
+            if (!improved) break;
+
+            const double relativeDecrease{(eq.cost - candidateCost) / eq.cost};
+            params = std::move(candidate);
+            lambda = std::max(lambda * .1, 1e-12);
+            result.iterations = iteration + 1;
+
+            if (relativeDecrease < options.tolerance) break;
+            buildNormalEquations(observations, frameObservations, params, fixed, eq);
+        }
+
+        const double cost{evaluateCost(observations, params, camCost, camPoints)};
+        int points{};
+        result.camRms.assign(numCams, 0.);
+        for (auto c{0}; c < numCams; ++c) {
+            if (camPoints[c] > 0) result.camRms[c] = std::sqrt(camCost[c] / camPoints[c]);
+            points += camPoints[c];
+        }
+        result.rms = points > 0 ? std::sqrt(cost / points) : 0.;
+
+        return result;
+    }
+} // YACCP::Calibration
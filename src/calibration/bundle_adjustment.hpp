@@ -0,0 +1,67 @@
+#ifndef YACCP_SRC_CALIBRATION_BUNDLE_ADJUSTMENT_HPP
+#define YACCP_SRC_CALIBRATION_BUNDLE_ADJUSTMENT_HPP
+#include <vector>
+
+#include <opencv2/core/matx.hpp>
+#include <opencv2/core/types.hpp>
+
+namespace YACCP::Calibration {
+    // fx, fy, cx, cy, k1, k2, p1, p2, k3
+    inline constexpr auto intrinsicParams{9};
+    // Rodrigues rotation vector followed by the translation.
+    inline constexpr auto poseParams{6};
+    inline constexpr auto camParams{intrinsicParams + poseParams};
+
+    using CamVec = cv::Vec<double, camParams>;
+
+    /**
+     * @brief Board corners seen by a single camera in a single frame.
+     */
+    struct RigObservation {
+        int camId;
+        int frameId;
+        std::vector<cv::Point3f> objPoints;
+        std::vector<cv::Point2f> imgPoints;
+    };
+
+    /**
+     * @brief Parameters of a multi-camera rig.
+     *
+     * @param cams Per camera the intrinsics followed by the pose from the reference camera to this camera.
+     * @param frames Per frame the pose from the board to the reference camera.
+     */
+    struct RigParameters {
+        std::vector<CamVec> cams;
+        std::vector<cv::Vec6d> frames;
+    };
+
+    struct BundleAdjustmentOptions {
+        int referenceCam{0};
+        bool fixIntrinsics{false};
+        int maxIterations{100};
+        double tolerance{1e-10};
+    };
+
+    struct BundleAdjustmentResult {
+        double rms{};
+        std::vector<double> camRms;
+        int iterations{};
+    };
+
+    /**
+     * @brief Jointly refine all intrinsics, camera poses and board poses of a rig with Levenberg-Marquardt.
+     *
+     * The board poses are eliminated with the Schur complement, so the linear system that is solved every iteration
+     * only contains the camera parameters. The analytic Jacobians and normal equations are assembled per frame in
+     * parallel. With a single camera this is the mono calibration problem, every frame being one view.
+     *
+     * @param observations All observations, camId and frameId index into params.
+     * @param params Initial parameters, refined in place.
+     * @param options Solver options, the pose of the reference camera is kept fixed.
+     */
+    BundleAdjustmentResult bundleAdjust(const std::vector<RigObservation>& observations,
+                                        RigParameters& params,
+                                        const BundleAdjustmentOptions& options);
+} // YACCP::Calibration
+
+#endif //YACCP_SRC_CALIBRATION_BUNDLE_ADJUSTMENT_HPP
@@ -0,0 +1,187 @@
+#include "remap_table.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace YACCP::Calibration {
+    namespace {
+        constexpr std::uint64_t fnvOffsetBasis{14695981039346656037ULL};
+        constexpr std::uint64_t fnvPrime{1099511628211ULL};
+
+
+        std::uint64_t fnv1a(const unsigned char* data, const std::size_t size, std::uint64_t hash = fnvOffsetBasis) {
+            for (std::size_t i{0}; i < size; ++i) {
+                hash ^= data[i];
+                hash *= fnvPrime;
+            }
+            return hash;
+        }
+    }
+
+
+    void RemapTable::write(const std::filesystem::path& path, const cv::Mat& map1, const cv::Mat& map2) {
+        if (map1.type() != CV_16SC2 || map2.type() != CV_16UC1 || map1.size() != map2.size())
+            throw std::runtime_error("Remap table expects a CV_16SC2 and CV_16UC1 map of the same size.");
+
+        const cv::Mat xy{map1.isContinuous() ? map1 : map1.clone()};
+        const cv::Mat weights{map2.isContinuous() ? map2 : map2.clone()};
+
+        RemapTableHeader header{};
+        header.magic = remapMagic;
+        header.version = remapVersion;
+        header.width = static_cast<std::uint32_t>(xy.cols);
+        header.height = static_cast<std::uint32_t>(xy.rows);
+        header.payloadOffset = remapPayloadAlignment;
+        header.payloadSize = xy.total() * xy.elemSize() + weights.total() * weights.elemSize();
+        header.checksum = fnv1a(weights.ptr<unsigned char>(),
+                                weights.total() * weights.elemSize(),
+                                fnv1a(xy.ptr<unsigned char>(), xy.total() * xy.elemSize()));
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Could not open " + path.string() + " for writing.");
+
+        (void)file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        (void)file.write(xy.ptr<char>(), static_cast<std::streamsize>(xy.total() * xy.elemSize()));
+        (void)file.write(weights.ptr<char>(), static_cast<std::streamsize>(weights.total() * weights.elemSize()));
+        if (!file) throw std::runtime_error("Failed writing remap table " + path.string());
+    }
+
+
+    RemapTable::RemapTable(const std::filesystem::path& path, const bool verifyChecksum) {
+#if defined(_WIN32)
+        file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            file_ = nullptr;
+            throw std::runtime_error("Could not open remap table " + path.string());
+        }
+
+        LARGE_INTEGER fileSize;
+        (void)GetFileSizeEx(file_, &fileSize);
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr) data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (data_ == nullptr) {
+            unmap();
+            throw std::runtime_error("Could not map remap table " + path.string());
+        }
+#else
+        const int fd{open(path.c_str(), O_RDONLY)};
+        if (fd < 0) throw std::runtime_error("Could not open remap table " + path.string());
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) == 0) size_ = static_cast<std::size_t>(fileStat.st_size);
+        if (size_ > 0) {
+            data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data_ == MAP_FAILED) data_ = nullptr;
+        }
+        // The mapping stays valid after the descriptor is closed.
+        (void)close(fd);
+
+        if (data_ == nullptr) throw std::runtime_error("Could not map remap table " + path.string());
+#endif
+
+        RemapTableHeader header{};
+        if (size_ >= sizeof(header)) std::memcpy(&header, data_, sizeof(header));
+
+        const std::uint64_t pixels{static_cast<std::uint64_t>(header.width) * header.height};
+        if (size_ < sizeof(header) || header.magic != remapMagic || header.version != remapVersion ||
+            header.payloadSize != pixels * (2 * sizeof(std::int16_t) + sizeof(std::uint16_t)) ||
+            header.payloadOffset + header.payloadSize > size_) {
+            unmap();
+            throw std::runtime_error("Remap table " + path.string() + " is invalid or was written by another version.");
+        }
+
+        auto* payload{static_cast<unsigned char*>(data_) + header.payloadOffset};
+        if (verifyChecksum && fnv1a(payload, header.payloadSize) != header.checksum) {
+            unmap();
+            throw std::runtime_error("Checksum mismatch in remap table " + path.string());
+        }
+
+        // cv::remap only reads the maps, so the read-only mapping can back the Mat headers directly.
+        const auto rows{static_cast<int>(header.height)};
+        const auto cols{static_cast<int>(header.width)};
+        map1_ = cv::Mat(rows, cols, CV_16SC2, payload);
+        map2_ = cv::Mat(rows, cols, CV_16UC1, payload + pixels * 2 * sizeof(std::int16_t));
+    }
+
+
+    RemapTable::~RemapTable() {
+        unmap();
+    }
+
+
+    void RemapTable::unmap() {
+        map1_.release();
+        map2_.release();
+#if defined(_WIN32)
+        if (data_ != nullptr) (void)UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) (void)CloseHandle(mapping_);
+        if (file_ != nullptr) (void)CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = nullptr;
+#else
+        if (data_ != nullptr) (void)munmap(data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+
+    void RemapTable::apply(const cv::Mat& src, cv::Mat& dst) const {
+        dst.create(map1_.size(), src.type());
+        const int tiles{(map1_.rows + GlobalVariables::remapTileRows - 1) / GlobalVariables::remapTileRows};
+
+        // The fixed-point maps make cv::remap use its vectorised integer bilinear path, the tiles keep every map and
+        // destination row range of a single tile in cache.
+        cv::parallel_for_(cv::Range(0, tiles),
+                          [&](const cv::Range& range) {
+                              for (auto tile{range.start}; tile < range.end; ++tile) {
+                                  const int begin{tile * GlobalVariables::remapTileRows};
+                                  const int end{std::min(begin + GlobalVariables::remapTileRows, map1_.rows)};
+                                  cv::Mat dstTile{dst.rowRange(begin, end)};
+                                  cv::remap(src,
+                                            dstTile,
+                                            map1_.rowRange(begin, end),
+                                            map2_.rowRange(begin, end),
+                                            cv::INTER_LINEAR,
+                                            cv::BORDER_CONSTANT);
+                              }
+                          });
+    }
+
+
+    const cv::Mat& RemapTable::map1() const {
+        return map1_;
+    }
+
+
+    const cv::Mat& RemapTable::map2() const {
+        return map2_;
+    }
+
+
+    cv::Size RemapTable::size() const {
+        return map1_.size();
+    }
+} // YACCP::Calibration
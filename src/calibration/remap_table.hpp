@@ -0,0 +1,83 @@
+#ifndef YACCP_SRC_CALIBRATION_REMAP_TABLE_HPP
+#define YACCP_SRC_CALIBRATION_REMAP_TABLE_HPP
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+#include <opencv2/core/mat.hpp>
+
+namespace YACCP::Calibration {
+    inline constexpr std::array<char, 8> remapMagic{'Y', 'A', 'C', 'C', 'P', 'M', 'A', 'P'};
+    inline constexpr std::uint32_t remapVersion{1};
+    inline constexpr std::uint64_t remapPayloadAlignment{64};
+
+    /**
+     * @brief On-disk header of a remap table, followed by the payload at payloadOffset.
+     *
+     * The payload is the CV_16SC2 integer map followed by the CV_16UC1 interpolation map as produced by
+     * cv::initUndistortRectifyMap, both stored row-major without padding. The checksum is FNV-1a over the payload.
+     */
+    struct RemapTableHeader {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t reserved;
+        std::uint64_t payloadOffset;
+        std::uint64_t payloadSize;
+        std::uint64_t checksum;
+        std::array<std::uint8_t, 16> padding;
+    };
+
+    static_assert(sizeof(RemapTableHeader) == remapPayloadAlignment);
+
+    /**
+     * @brief Read-only memory mapped fixed-point remap table, ready to be passed to cv::remap without copying.
+     */
+    class RemapTable {
+    public:
+        /**
+         * @param path Table written with RemapTable::write.
+         * @param verifyChecksum Whether to checksum the payload, skipping it avoids touching every page up front.
+         */
+        explicit RemapTable(const std::filesystem::path& path, bool verifyChecksum = true);
+
+        ~RemapTable();
+
+        RemapTable(const RemapTable&) = delete;
+
+        RemapTable& operator=(const RemapTable&) = delete;
+
+        /**
+         * @param map1 CV_16SC2 map.
+         * @param map2 CV_16UC1 interpolation map of the same size.
+         */
+        static void write(const std::filesystem::path& path, const cv::Mat& map1, const cv::Mat& map2);
+
+        /**
+         * @brief Bilinear remap of src into dst, split in row tiles that are remapped in parallel.
+         */
+        void apply(const cv::Mat& src, cv::Mat& dst) const;
+
+        [[nodiscard]] const cv::Mat& map1() const;
+
+        [[nodiscard]] const cv::Mat& map2() const;
+
+        [[nodiscard]] cv::Size size() const;
+
+
+    private:
+        void* data_{};
+        std::size_t size_{};
+#if defined(_WIN32)
+        void* file_{};
+        void* mapping_{};
+#endif
+        cv::Mat map1_;
+        cv::Mat map2_;
+
+        void unmap();
+    };
+} // YACCP::Calibration
+
+#endif //YACCP_SRC_CALIBRATION_REMAP_TABLE_HPP
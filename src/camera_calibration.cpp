@@ -4,6 +4,25 @@
 
 #include "utility.hpp"
 
+#include "calibration/bundle_adjustment.hpp"
+#include "calibration/remap_table.hpp"
+
+#include "detection/board_detection.hpp"
+
+#include "global_variables/program_defaults.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <opencv2/core/affine.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
 namespace YACCP::Calibration {
     static void filterByOverlapIds(
         const Utility::CharucoResults& resultsLeft,
@@ -69,64 +88,890 @@ namespace YACCP::Calibration {
     }
 
 
-    void monoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
-                       std::vector<CamData>& camDatas,
-                       const Config::FileConfig& fileConfig,
-                       const std::filesystem::path& jobPath) {
-        std::vector<std::filesystem::path> cams;
-        std::vector<std::filesystem::path> files;
+    // Detect the board in every image of every camera, the images are processed in parallel.
+    static std::vector<std::vector<Utility::CharucoResults> > detectBoards(
+        const cv::aruco::CharucoDetector& charucoDetector,
+        const std::vector<std::filesystem::path>& cams,
+        const std::vector<std::filesystem::path>& files,
+        const int cornerMin,
+        const Config::DetectionConfig& detectionConfig) {
+        std::vector detections(cams.size(), std::vector<Utility::CharucoResults>(files.size()));
+        const auto total{static_cast<int>(cams.size() * files.size())};
+
+        cv::parallel_for_(cv::Range(0, total),
+                          [&](const cv::Range& range) {
+                              // The detector is not safe to share between threads, every stripe gets its own.
+                              const cv::aruco::CharucoDetector detector{
+                                  charucoDetector.getBoard(),
+                                  charucoDetector.getCharucoParameters(),
+                                  charucoDetector.getDetectorParameters(),
+                                  charucoDetector.getRefineParameters()
+                              };
+
+                              for (auto i{range.start}; i < range.end; ++i) {
+                                  const std::size_t cam{i / files.size()};
+                                  const std::size_t file{i % files.size()};
+                                  cv::Mat img{cv::imread((cams[cam] / files[file]).string(), cv::IMREAD_GRAYSCALE)};
+                                  if (img.empty()) continue;
+
+                                  detections[cam][file] = findBoardConfigured(detector,
+                                                                              img,
+                                                                              cornerMin,
+                                                                              detectionConfig);
+                              }
+                          });
+
+        return detections;
+    }
+
+
+    struct CameraPair {
+        int from;
+        int to;
+        int overlap;
+    };
+
+
+    // Amount of board corners seen by both cameras of every pair, summed over all views.
+    static std::vector<std::vector<int> > countPairOverlap(
+        const std::vector<std::vector<Utility::CharucoResults> >& detections) {
+        const auto numCams{static_cast<int>(detections.size())};
+        std::vector overlap(numCams, std::vector<int>(numCams));
+
+        cv::parallel_for_(cv::Range(0, numCams),
+                          [&](const cv::Range& range) {
+                              for (auto left{range.start}; left < range.end; ++left) {
+                                  for (auto right{left + 1}; right < numCams; ++right) {
+                                      for (std::size_t f{0}; f < detections[left].size(); ++f) {
+                                          const auto& resultsLeft{detections[left][f]};
+                                          const auto& resultsRight{detections[right][f]};
+                                          if (!resultsLeft.boardFound || !resultsRight.boardFound) continue;
+
+                                          overlap[left][right] += static_cast<int>(
+                                              Utility::intersection(resultsLeft.charucoIds, resultsRight.charucoIds).
+                                              size());
+                                      }
+                                  }
+                              }
+                          });
+
+        for (auto left{0}; left < numCams; ++left) {
+            for (auto right{left + 1}; right < numCams; ++right) overlap[right][left] = overlap[left][right];
+        }
+
+        return overlap;
+    }
+
+
+    /**
+     * @brief Maximum overlap spanning tree rooted at the first camera.
+     *
+     * The edges are returned in the order they were added, so the from camera of an edge is always connected to the
+     * root by the edges before it.
+     */
+    static std::vector<CameraPair> maximumSpanningTree(const std::vector<std::vector<int> >& overlap,
+                                                       const std::vector<CamData>& camDatas) {
+        const auto numCams{static_cast<int>(overlap.size())};
+        std::vector<CameraPair> edges;
+        std::vector inTree(numCams, false);
+        inTree.front() = true;
+
+        for (auto added{1}; added < numCams; ++added) {
+            CameraPair best{-1, -1, 0};
+            for (auto from{0}; from < numCams; ++from) {
+                if (!inTree[from]) continue;
+                for (auto to{0}; to < numCams; ++to) {
+                    if (inTree[to] || overlap[from][to] <= best.overlap) continue;
+                    best = {from, to, overlap[from][to]};
+                }
+            }
+
+            if (best.to < 0) {
+                for (auto c{0}; c < numCams; ++c) {
+                    if (inTree[c]) continue;
+                    throw std::runtime_error("Camera: " + camDatas[c].info.camName + " with ID: " +
+                                             std::to_string(camDatas[c].info.camIndexId) +
+                                             "\nShares no board corners with the other cameras, it can not be added to the rig.");
+                }
+            }
+
+            inTree[best.to] = true;
+            edges.emplace_back(best);
+        }
+
+        return edges;
+    }
+
+
+    struct StereoViews {
+        std::vector<std::vector<cv::Point3f> > objPoints;
+        std::vector<std::vector<cv::Point2f> > imgPointsLeft;
+        std::vector<std::vector<cv::Point2f> > imgPointsRight;
+    };
+
+
+    // Corners seen by both cameras of a pair, per view.
+    static StereoViews collectStereoViews(const cv::aruco::CharucoBoard& board,
+                                          const std::vector<std::vector<Utility::CharucoResults> >& detections,
+                                          const int left,
+                                          const int right) {
+        StereoViews views;
+
+        for (std::size_t f{0}; f < detections[left].size(); ++f) {
+            const auto& resultsLeft{detections[left][f]};
+            const auto& resultsRight{detections[right][f]};
+            if (!resultsLeft.boardFound || !resultsRight.boardFound) continue;
+
+            std::vector<cv::Point3f> objPointsLeft, objPointsRight;
+            std::vector<cv::Point2f> imgPointsLeft, imgPointsRight;
+            std::vector<cv::Point2f> overlapCornersLeft, overlapCornersRight;
+            std::vector<int> overlapIds;
+
+            filterByOverlapIds(resultsLeft, resultsRight, overlapCornersLeft, overlapCornersRight, overlapIds);
+            if (overlapIds.size() < 4) continue;
+
+            board.matchImagePoints(overlapCornersLeft, overlapIds, objPointsLeft, imgPointsLeft);
+            board.matchImagePoints(overlapCornersRight, overlapIds, objPointsRight, imgPointsRight);
+
+            views.objPoints.emplace_back(objPointsLeft);
+            views.imgPointsLeft.emplace_back(imgPointsLeft);
+            views.imgPointsRight.emplace_back(imgPointsRight);
+        }
+
+        return views;
+    }
+
+
+    static double stereoCalibrateViews(const StereoViews& views,
+                                       const CamData::CalibData& calibDataLeft,
+                                       const CamData::CalibData& calibDataRight,
+                                       StereoCalibData& stereoCalibData,
+                                       const int flags) {
+        // The intrinsics are fixed, the copies only keep concurrent calibrations from sharing output arrays.
+        cv::Mat cameraMatrixLeft{calibDataLeft.cameraMatrix.clone()};
+        cv::Mat distCoeffsLeft{calibDataLeft.distCoeffs.clone()};
+        cv::Mat cameraMatrixRight{calibDataRight.cameraMatrix.clone()};
+        cv::Mat distCoeffsRight{calibDataRight.distCoeffs.clone()};
+
+        return cv::stereoCalibrate(views.objPoints,
+                                   views.imgPointsLeft,
+                                   views.imgPointsRight,
+                                   cameraMatrixLeft,
+                                   distCoeffsLeft,
+                                   cameraMatrixRight,
+                                   distCoeffsRight,
+                                   cv::Size(0, 0),
+                                   stereoCalibData.rotationMatrix,
+                                   stereoCalibData.translationMatrix,
+                                   stereoCalibData.essentialMatrix,
+                                   stereoCalibData.fundamentalMatrix,
+                                   cv::noArray(),
+                                   cv::CALIB_FIX_INTRINSIC | flags);
+    }
+
+
+    // Resampled view indices, drawn up front so the runs do not depend on the thread schedule.
+    static std::vector<std::vector<int> > bootstrapSamples(const int views, const int runs) {
+        cv::RNG rng{GlobalVariables::bootstrapSeed};
+        std::vector samples(runs, std::vector<int>(views));
+        for (auto& sample : samples) {
+            for (auto& index : sample) index = rng.uniform(0, views);
+        }
+
+        return samples;
+    }
+
+
+    // Standard deviation of every column over all rows, rows of failed runs are empty and skipped.
+    static cv::Mat columnStdDevs(const std::vector<cv::Mat>& rows) {
+        std::vector<cv::Mat> validRows;
+        for (const auto& row : rows) {
+            if (!row.empty()) validRows.emplace_back(row);
+        }
+        if (validRows.size() < 2) return {};
+
+        cv::Mat samples;
+        cv::vconcat(validRows, samples);
+
+        cv::Mat stdDevs(1, samples.cols, CV_64F);
+        for (auto c{0}; c < samples.cols; ++c) {
+            cv::Scalar mean;
+            cv::Scalar stdDev;
+            cv::meanStdDev(samples.col(c), mean, stdDev);
+            stdDevs.at<double>(c) = stdDev[0];
+        }
+
+        return stdDevs;
+    }
+
+
+    /**
+     * @brief Spread of the extrinsics of a pair over bootstrap resamples of its views.
+     *
+     * Every resample is warm-started from the full solution and the resamples run in parallel.
+     */
+    static void bootstrapStereo(const StereoViews& views,
+                                const CamData::CalibData& calibDataLeft,
+                                const CamData::CalibData& calibDataRight,
+                                StereoCalibData& stereoCalibData,
+                                const int runs) {
+        const auto samples{bootstrapSamples(static_cast<int>(views.objPoints.size()), runs)};
+        std::vector<cv::Mat> translations(runs);
+        std::vector<cv::Mat> spreads(runs);
+
+        cv::parallel_for_(cv::Range(0, runs),
+                          [&](const cv::Range& range) {
+                              for (auto run{range.start}; run < range.end; ++run) {
+                                  StereoViews resampled;
+                                  for (const int index : samples[run]) {
+                                      resampled.objPoints.emplace_back(views.objPoints[index]);
+                                      resampled.imgPointsLeft.emplace_back(views.imgPointsLeft[index]);
+                                      resampled.imgPointsRight.emplace_back(views.imgPointsRight[index]);
+                                  }
+
+                                  StereoCalibData resample;
+                                  resample.rotationMatrix = stereoCalibData.rotationMatrix.clone();
+                                  resample.translationMatrix = stereoCalibData.translationMatrix.clone();
+                                  try {
+                                      (void)stereoCalibrateViews(resampled,
+                                                                 calibDataLeft,
+                                                                 calibDataRight,
+                                                                 resample,
+                                                                 cv::CALIB_USE_EXTRINSIC_GUESS);
+                                  }
+                                  catch (const cv::Exception&) {
+                                      // A degenerate resample is skipped.
+                                      continue;
+                                  }
+
+                                  // Rotation difference with the full solution as an angle.
+                                  cv::Mat rotationDifference;
+                                  cv::Rodrigues(resample.rotationMatrix * stereoCalibData.rotationMatrix.t(),
+                                                rotationDifference);
+                                  translations[run] = resample.translationMatrix.reshape(1, 1).clone();
+                                  spreads[run] = (cv::Mat_<double>(1, 2) << cv::norm(resample.translationMatrix),
+                                                  cv::norm(rotationDifference) * 180. / CV_PI);
+                              }
+                          });
+
+        const cv::Mat spreadStdDevs{columnStdDevs(spreads)};
+        stereoCalibData.translationStdDevs = columnStdDevs(translations);
+        if (spreadStdDevs.empty()) return;
+
+        // The rotation differences are already relative to the full solution, so their RMS is the spread.
+        double rotationSquared{};
+        auto validRuns{0};
+        for (const auto& spread : spreads) {
+            if (spread.empty()) continue;
+            rotationSquared += spread.at<double>(1) * spread.at<double>(1);
+            ++validRuns;
+        }
+        stereoCalibData.baselineStdDev = spreadStdDevs.at<double>(0);
+        stereoCalibData.rotationStdDev = std::sqrt(rotationSquared / validRuns);
+
+        std::cout << "  Bootstrap of " << validRuns << " runs, baseline std dev: " << stereoCalibData.baselineStdDev <<
+            ", rotation spread: " << stereoCalibData.rotationStdDev << " deg\n";
+    }
+
+
+    // Stereo calibrate a single pair from detections that were already made, returns the RMS error.
+    static double stereoCalibratePair(const cv::aruco::CharucoBoard& board,
+                                      const std::vector<std::vector<Utility::CharucoResults> >& detections,
+                                      std::vector<CamData>& camDatas,
+                                      const int left,
+                                      const int right,
+                                      StereoCalibData& stereoCalibData,
+                                      const int bootstrapRuns = 0) {
+        stereoCalibData.camLeftId = left;
+        stereoCalibData.camRightId = right;
+
+        const StereoViews views{collectStereoViews(board, detections, left, right)};
+        const double rms{
+            stereoCalibrateViews(views,
+                                 camDatas[left].info.calibData,
+                                 camDatas[right].info.calibData,
+                                 stereoCalibData,
+                                 0)
+        };
+
+        if (bootstrapRuns > 0) {
+            bootstrapStereo(views,
+                            camDatas[left].info.calibData,
+                            camDatas[right].info.calibData,
+                            stereoCalibData,
+                            bootstrapRuns);
+        }
+
+        return rms;
+    }
+
+
+    static void checkMonoCalibration(const std::vector<CamData>& camDatas) {
+        for (const auto& [info, runtimeData] : camDatas) {
+            if (info.calibData.cameraMatrix.empty() || info.calibData.distCoeffs.empty())
+                throw std::runtime_error("Camera: " + info.camName + " with ID: " + std::to_string(info.camIndexId) +
+                                         "\nIs missing its camera matrix or distance coefficients vector, did you run mono calibration?");
+        }
+    }
+
 
-        // Get all camera directories in the given job path.
+    // Camera directories in the order of the camera IDs, getCamDirs sorts them by name. The files are those of every
+    // camera, a set may only have been accepted for part of the cameras.
+    static std::vector<std::filesystem::path> getOrderedCamDirs(std::vector<CamData>& camDatas,
+                                                                const std::filesystem::path& jobPath,
+                                                                std::vector<std::filesystem::path>& files) {
+        std::vector<std::filesystem::path> cams;
         getCamDirs(cams, camDatas, jobPath);
-        // Get all the file indexes, only a single camera directory needs to be looked at,
-        // since the filenames are the same across the multiple cameras.
-        getImages(cams.front(), files);
+        for (const auto& cam : cams) getImages(cam, files);
+        std::ranges::sort(files);
+        const auto [first, last]{std::ranges::unique(files)};
+        (void)files.erase(first, last);
+
+        cams.clear();
+        for (const auto& [info, runtimeData] : camDatas) {
+            cams.emplace_back(jobPath / "images" / "verified" / ("cam_" + std::to_string(info.camIndexId)));
+        }
+
+        return cams;
+    }
+
+
+    struct MonoView {
+        std::size_t file;
+        std::vector<cv::Point3f> objPoints;
+        std::vector<cv::Point2f> imgPoints;
+        int rejectedCorners{};
+    };
+
 
-        cv::aruco::CharucoBoard board{charucoDetector.getBoard()};
-        cv::Size boardSize = board.getChessboardSize();
-        int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+    static double calibrateViewsOpenCv(const std::vector<MonoView>& views,
+                                       const cv::Size resolution,
+                                       CamData::CalibData& calibData,
+                                       const int flags) {
+        std::vector<std::vector<cv::Point3f> > allObjPoints;
+        std::vector<std::vector<cv::Point2f> > allImgPoints;
+        for (const auto& view : views) {
+            allObjPoints.emplace_back(view.objPoints);
+            allImgPoints.emplace_back(view.imgPoints);
+        }
+
+        return cv::calibrateCamera(allObjPoints,
+                                   allImgPoints,
+                                   resolution,
+                                   calibData.cameraMatrix,
+                                   calibData.distCoeffs,
+                                   calibData.rvecs,
+                                   calibData.tvecs,
+                                   flags);
+    }
 
-        auto i{0};
-        for (auto& cam : cams) {
+
+    /**
+     * @brief Mono calibration as a single camera bundle adjustment, every view is a frame of the rig.
+     *
+     * Uses the same 5 coefficient distortion model and RMS definition as cv::calibrateCamera. Without an intrinsic
+     * guess the initialisation matches OpenCV as well, cv::initCameraMatrix2D with zero distortion.
+     */
+    static double calibrateViewsNative(const std::vector<MonoView>& views,
+                                       const cv::Size resolution,
+                                       CamData::CalibData& calibData,
+                                       const int flags) {
+        if (!(flags & cv::CALIB_USE_INTRINSIC_GUESS) || calibData.cameraMatrix.empty()) {
             std::vector<std::vector<cv::Point3f> > allObjPoints;
             std::vector<std::vector<cv::Point2f> > allImgPoints;
+            for (const auto& view : views) {
+                allObjPoints.emplace_back(view.objPoints);
+                allImgPoints.emplace_back(view.imgPoints);
+            }
+            calibData.cameraMatrix = cv::initCameraMatrix2D(allObjPoints, allImgPoints, resolution);
+            calibData.distCoeffs = cv::Mat::zeros(1, 5, CV_64F);
+        }
 
-            for (auto& file : files) {
-                std::vector<cv::Point3f> objPoints;
-                std::vector<cv::Point2f> imgPoints;
-                // TODO: add progressbar for image loading & detection.
-                cv::Mat img{cv::imread((cam / file).string(), cv::IMREAD_GRAYSCALE)};
-
-                Utility::CharucoResults results{
-                    Utility::findBoard(charucoDetector,
-                                       img,
-                                       std::floor(
-                                           static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin))
-                };
+        cv::Mat cameraMatrix;
+        cv::Mat distCoeffs;
+        calibData.cameraMatrix.convertTo(cameraMatrix, CV_64F);
+        calibData.distCoeffs.convertTo(distCoeffs, CV_64F);
+        distCoeffs = distCoeffs.reshape(1, 1);
+
+        RigParameters params;
+        CamVec cam{};
+        cam[0] = cameraMatrix.at<double>(0, 0);
+        cam[1] = cameraMatrix.at<double>(1, 1);
+        cam[2] = cameraMatrix.at<double>(0, 2);
+        cam[3] = cameraMatrix.at<double>(1, 2);
+        for (auto k{0}; k < std::min(distCoeffs.cols, 5); ++k) cam[4 + k] = distCoeffs.at<double>(0, k);
+        params.cams.emplace_back(cam);
+
+        // Initial board poses from the current intrinsics, independent per view.
+        params.frames.resize(views.size());
+        cv::parallel_for_(cv::Range(0, static_cast<int>(views.size())),
+                          [&](const cv::Range& range) {
+                              for (auto v{range.start}; v < range.end; ++v) {
+                                  cv::Vec3d rvec;
+                                  cv::Vec3d tvec;
+                                  if (!cv::solvePnP(views[v].objPoints,
+                                                    views[v].imgPoints,
+                                                    cameraMatrix,
+                                                    distCoeffs,
+                                                    rvec,
+                                                    tvec))
+                                      CV_Error(cv::Error::StsNoConv, "Could not initialise the pose of a view");
+                                  params.frames[v] = {rvec[0], rvec[1], rvec[2], tvec[0], tvec[1], tvec[2]};
+                              }
+                          });
+
+        std::vector<RigObservation> observations;
+        observations.reserve(views.size());
+        for (std::size_t v{0}; v < views.size(); ++v) {
+            observations.push_back({0, static_cast<int>(v), views[v].objPoints, views[v].imgPoints});
+        }
+
+        const auto result{bundleAdjust(observations, params, {})};
+
+        const CamVec& solved{params.cams[0]};
+        calibData.cameraMatrix = (cv::Mat_<double>(3, 3) <<
+            solved[0], 0., solved[2],
+            0., solved[1], solved[3],
+            0., 0., 1.);
+        calibData.distCoeffs = (cv::Mat_<double>(1, 5) << solved[4], solved[5], solved[6], solved[7], solved[8]);
+
+        calibData.rvecs.clear();
+        calibData.tvecs.clear();
+        for (const auto& frame : params.frames) {
+            calibData.rvecs.emplace_back((cv::Mat_<double>(3, 1) << frame[0], frame[1], frame[2]));
+            calibData.tvecs.emplace_back((cv::Mat_<double>(3, 1) << frame[3], frame[4], frame[5]));
+        }
+
+        return result.rms;
+    }
+
+
+    static double calibrateViews(const std::vector<MonoView>& views,
+                                 const cv::Size resolution,
+                                 CamData::CalibData& calibData,
+                                 const int flags,
+                                 const MonoSolver solver) {
+        if (solver == MonoSolver::Native) return calibrateViewsNative(views, resolution, calibData, flags);
+        return calibrateViewsOpenCv(views, resolution, calibData, flags);
+    }
+
+
+    /**
+     * @brief Calibrate the same views with both solvers and report the timing and the difference of the solutions.
+     *
+     * The solution of the selected solver is kept.
+     */
+    static double benchmarkSolvers(const std::vector<MonoView>& views,
+                                   const cv::Size resolution,
+                                   CamData::CalibData& calibData,
+                                   const int flags,
+                                   const MonoSolver solver) {
+        std::array<CamData::CalibData, 2> solutions;
+        std::array<double, 2> rms{};
+        std::array<double, 2> seconds{};
+        for (const auto candidate : {MonoSolver::OpenCv, MonoSolver::Native}) {
+            const auto index{static_cast<std::size_t>(candidate)};
+            solutions[index].cameraMatrix = calibData.cameraMatrix.clone();
+            solutions[index].distCoeffs = calibData.distCoeffs.clone();
+
+            const auto start{std::chrono::steady_clock::now()};
+            rms[index] = calibrateViews(views, resolution, solutions[index], flags, candidate);
+            seconds[index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        const auto& openCv{solutions[static_cast<std::size_t>(MonoSolver::OpenCv)]};
+        const auto& native{solutions[static_cast<std::size_t>(MonoSolver::Native)]};
+        cv::Mat openCvK;
+        cv::Mat nativeK;
+        openCv.cameraMatrix.convertTo(openCvK, CV_64F);
+        native.cameraMatrix.convertTo(nativeK, CV_64F);
+        const double focalDifference{
+            std::max(std::abs(openCvK.at<double>(0, 0) - nativeK.at<double>(0, 0)) / openCvK.at<double>(0, 0),
+                     std::abs(openCvK.at<double>(1, 1) - nativeK.at<double>(1, 1)) / openCvK.at<double>(1, 1))
+        };
+        const double principalDifference{
+            std::max(std::abs(openCvK.at<double>(0, 2) - nativeK.at<double>(0, 2)),
+                     std::abs(openCvK.at<double>(1, 2) - nativeK.at<double>(1, 2)))
+        };
+
+        std::cout << "  Solver benchmark on " << views.size() << " views\n" <<
+            "    OpenCV: " << seconds[0] << " s, RMS: " << rms[0] << " px\n" <<
+            "    Native: " << seconds[1] << " s, RMS: " << rms[1] << " px\n" <<
+            "    Max relative focal length difference: " << focalDifference <<
+            ", max principal point difference: " << principalDifference << " px\n";
+
+        const auto selected{static_cast<std::size_t>(solver)};
+        calibData.cameraMatrix = solutions[selected].cameraMatrix;
+        calibData.distCoeffs = solutions[selected].distCoeffs;
+        calibData.rvecs = std::move(solutions[selected].rvecs);
+        calibData.tvecs = std::move(solutions[selected].tvecs);
+        return rms[selected];
+    }
+
+
+    // Reprojection error of every corner as a CV_32F column per view, the views are processed in parallel.
+    static std::vector<cv::Mat> cornerErrors(const std::vector<MonoView>& views, const CamData::CalibData& calibData) {
+        std::vector<cv::Mat> errors(views.size());
+
+        cv::parallel_for_(cv::Range(0, static_cast<int>(views.size())),
+                          [&](const cv::Range& range) {
+                              std::vector<cv::Point2f> projected;
+                              cv::Mat channels[2];
+                              for (auto v{range.start}; v < range.end; ++v) {
+                                  cv::projectPoints(views[v].objPoints,
+                                                    calibData.rvecs[v],
+                                                    calibData.tvecs[v],
+                                                    calibData.cameraMatrix,
+                                                    calibData.distCoeffs,
+                                                    projected);
+                                  cv::split(cv::Mat(projected) - cv::Mat(views[v].imgPoints), channels);
+                                  cv::magnitude(channels[0], channels[1], errors[v]);
+                              }
+                          });
+
+        return errors;
+    }
+
+
+    static float median(std::vector<float> values) {
+        if (values.empty()) return 0.f;
+
+        const auto middle{values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2)};
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+
+    static CamData::ViewError viewError(const MonoView& view,
+                                        const cv::Mat& errors,
+                                        const std::vector<std::filesystem::path>& files,
+                                        const bool rejected) {
+        CamData::ViewError stats;
+        stats.file = files[view.file].string();
+        stats.rms = std::sqrt(errors.dot(errors) / std::max(errors.rows, 1));
+        cv::minMaxLoc(errors, nullptr, &stats.maxError);
+        stats.corners = errors.rows;
+        stats.rejectedCorners = view.rejectedCorners;
+        stats.rejected = rejected;
+
+        return stats;
+    }
+
+
+    /**
+     * @brief Standard deviation of the intrinsics over bootstrap resamples of the views.
+     *
+     * Every resample is warm-started from the full solution and the resamples run in parallel.
+     */
+    static void bootstrapMono(const std::vector<MonoView>& views,
+                              const cv::Size resolution,
+                              CamData::CalibData& calibData,
+                              const int runs,
+                              const MonoSolver solver) {
+        const auto samples{bootstrapSamples(static_cast<int>(views.size()), runs)};
+        std::vector<cv::Mat> parameters(runs);
+
+        cv::parallel_for_(cv::Range(0, runs),
+                          [&](const cv::Range& range) {
+                              for (auto run{range.start}; run < range.end; ++run) {
+                                  std::vector<MonoView> resampled;
+                                  for (const int index : samples[run]) resampled.emplace_back(views[index]);
+
+                                  CamData::CalibData resample;
+                                  resample.cameraMatrix = calibData.cameraMatrix.clone();
+                                  resample.distCoeffs = calibData.distCoeffs.clone();
+                                  try {
+                                      (void)calibrateViews(resampled,
+                                                           resolution,
+                                                           resample,
+                                                           cv::CALIB_USE_INTRINSIC_GUESS,
+                                                           solver);
+                                  }
+                                  catch (const cv::Exception&) {
+                                      // A degenerate resample is skipped.
+                                      continue;
+                                  }
+
+                                  // fx, fy, cx, cy followed by the distortion coefficients.
+                                  cv::Mat row{
+                                      (cv::Mat_<double>(1, 4) << resample.cameraMatrix.at<double>(0, 0),
+                                       resample.cameraMatrix.at<double>(1, 1),
+                                       resample.cameraMatrix.at<double>(0, 2),
+                                       resample.cameraMatrix.at<double>(1, 2))
+                                  };
+                                  cv::hconcat(row, resample.distCoeffs.reshape(1, 1), row);
+                                  parameters[run] = row;
+                              }
+                          });
+
+        calibData.intrinsicStdDevs = columnStdDevs(parameters);
+        if (calibData.intrinsicStdDevs.empty()) return;
+
+        std::cout << "  Bootstrap std dev fx: " << calibData.intrinsicStdDevs.at<double>(0) << ", fy: " <<
+            calibData.intrinsicStdDevs.at<double>(1) << ", cx: " << calibData.intrinsicStdDevs.at<double>(2) <<
+            ", cy: " << calibData.intrinsicStdDevs.at<double>(3) << " px\n";
+    }
+
+
+    /**
+     * @brief Drop corners above a MAD based threshold and re-solve, warm-started from the previous solution.
+     *
+     * Views that keep too few corners are dropped as a whole. Stops once a round rejects nothing.
+     */
+    static void rejectOutliers(std::vector<MonoView>& views,
+                               const cv::Size resolution,
+                               CamData::CalibData& calibData,
+                               const std::vector<std::filesystem::path>& files,
+                               const MonoCalibrationOptions& options) {
+        std::vector<CamData::ViewError> rejectedViews;
+
+        for (auto round{0}; round < options.outlierRounds; ++round) {
+            const std::vector<cv::Mat> errors{cornerErrors(views, calibData)};
+
+            std::vector<float> allErrors;
+            for (const auto& viewErrors : errors) allErrors.insert(allErrors.end(), viewErrors.begin<float>(),
+                                                                   viewErrors.end<float>());
+            const float medianError{median(allErrors)};
+            for (auto& error : allErrors) error = std::abs(error - medianError);
+            // 1.4826 scales the MAD to the standard deviation of a normal distribution.
+            const double threshold{
+                std::max(medianError + options.outlierThreshold * 1.4826 * median(allErrors),
+                         GlobalVariables::outlierMinThreshold)
+            };
+
+            std::vector<MonoView> keptViews;
+            std::vector<CamData::ViewError> droppedViews;
+            auto rejectedCorners{0};
+            for (std::size_t v{0}; v < views.size(); ++v) {
+                MonoView kept{views[v].file};
+                kept.rejectedCorners = views[v].rejectedCorners;
+                for (auto i{0}; i < errors[v].rows; ++i) {
+                    if (errors[v].at<float>(i) > threshold) {
+                        ++kept.rejectedCorners;
+                        ++rejectedCorners;
+                        continue;
+                    }
+                    kept.objPoints.emplace_back(views[v].objPoints[i]);
+                    kept.imgPoints.emplace_back(views[v].imgPoints[i]);
+                }
+
+                if (kept.objPoints.size() < GlobalVariables::outlierMinCorners) {
+                    droppedViews.emplace_back(viewError(views[v], errors[v], files, true));
+                    continue;
+                }
+                keptViews.emplace_back(std::move(kept));
+            }
+
+            if (rejectedCorners == 0 && droppedViews.empty()) break;
+            if (keptViews.size() < GlobalVariables::calibrationMinViews) {
+                std::cout << "  Outlier rejection stopped, too few views would remain\n";
+                break;
+            }
+
+            views = std::move(keptViews);
+            rejectedViews.insert(rejectedViews.end(), droppedViews.begin(), droppedViews.end());
+            calibData.reprojError = calibrateViews(views,
+                                                   resolution,
+                                                   calibData,
+                                                   cv::CALIB_USE_INTRINSIC_GUESS,
+                                                   options.solver);
+
+            std::cout << "  Round " << round + 1 << ": rejected " << rejectedCorners << " corners above " << threshold
+                << " px, dropped " << droppedViews.size() << " views, RMS: " << calibData.reprojError << " px\n";
+        }
+
+        // Per-view statistics of the final solution, rejected views keep the error from when they were dropped.
+        const std::vector<cv::Mat> errors{cornerErrors(views, calibData)};
+        calibData.viewErrors = std::move(rejectedViews);
+        for (std::size_t v{0}; v < views.size(); ++v) {
+            calibData.viewErrors.emplace_back(viewError(views[v], errors[v], files, false));
+        }
+        std::ranges::sort(calibData.viewErrors, {}, &CamData::ViewError::file);
+    }
+
+
+    static std::string camUuid(const Config::FileConfig& fileConfig, const int camIndexId) {
+        for (const auto& worker : fileConfig.recordingConfig.workers) {
+            if (worker.placement == camIndexId) return worker.camUuid;
+        }
+        return {};
+    }
+
+
+    /**
+     * @brief Most recent calibration of the same physical camera in another job.
+     *
+     * Cameras are matched on their configured UUID, or on their name when no UUID was configured. Only calibrations
+     * made at the same resolution are considered.
+     *
+     * @param jobId Only look at this job, all other jobs are searched from newest to oldest when empty.
+     */
+    static std::optional<std::pair<std::string, CamData::CalibData> > findPreviousCalibration(
+        const std::filesystem::path& jobPath,
+        const Config::FileConfig& fileConfig,
+        const CamData::Info& info,
+        const std::string& jobId) {
+        const std::filesystem::path dataPath{jobPath.parent_path()};
+        const std::string uuid{camUuid(fileConfig, info.camIndexId)};
+
+        std::vector<std::filesystem::path> jobs;
+        if (!jobId.empty()) {
+            Utility::checkJobPath(dataPath, jobId);
+            jobs.emplace_back(dataPath / jobId);
+        } else {
+            for (const auto& entry : std::filesystem::directory_iterator(dataPath)) {
+                if (!entry.is_directory() || entry.path() == jobPath) continue;
+                if (!std::filesystem::exists(entry.path() / GlobalVariables::jobDataFileName)) continue;
+                jobs.emplace_back(entry.path());
+            }
+            // Job IDs contain their creation date, so sorting by name sorts them by age.
+            std::ranges::sort(jobs, std::ranges::greater{});
+        }
+
+        for (const auto& job : jobs) {
+            try {
+                nlohmann::json j = Utility::loadJobDataFromFile(job);
+                const Config::FileConfig previousConfig{Utility::parseJsonToFileConfig(j)};
+
+                for (auto& [key, obj] : j.at("cams").items()) {
+                    const auto previous{obj.get<CamData::Info>()};
+                    const bool sameCam{
+                        uuid.empty()
+                            ? previous.camName == info.camName
+                            : camUuid(previousConfig, previous.camIndexId) == uuid
+                    };
+                    if (!sameCam || previous.resolution != info.resolution) continue;
+                    if (previous.calibData.cameraMatrix.empty()) continue;
+
+                    return std::pair{job.filename().string(), previous.calibData};
+                }
+            }
+            catch (const std::exception&) {
+                // Jobs with missing or outdated job data are skipped.
+            }
+        }
+
+        return std::nullopt;
+    }
+
+
+    /**
+     * @brief Verify a previous calibration against the new detections, only the board poses are solved with PnP.
+     *
+     * @return Whether the previous calibration is still within the allowed drift, it is then stored for this job.
+     */
+    static bool quickCheck(std::vector<MonoView>& views,
+                           CamData::CalibData& calibData,
+                           const CamData::CalibData& previous,
+                           const std::vector<std::filesystem::path>& files) {
+        CamData::CalibData checked;
+        checked.cameraMatrix = previous.cameraMatrix.clone();
+        checked.distCoeffs = previous.distCoeffs.clone();
+
+        std::vector<MonoView> solved;
+        for (auto& view : views) {
+            cv::Mat rvec;
+            cv::Mat tvec;
+            if (!cv::solvePnP(view.objPoints, view.imgPoints, checked.cameraMatrix, checked.distCoeffs, rvec, tvec))
+                continue;
+
+            checked.rvecs.emplace_back(rvec);
+            checked.tvecs.emplace_back(tvec);
+            solved.emplace_back(std::move(view));
+        }
+        views = std::move(solved);
+
+        const std::vector<cv::Mat> errors{cornerErrors(views, checked)};
+        double squaredError{};
+        auto corners{0};
+        for (std::size_t v{0}; v < views.size(); ++v) {
+            squaredError += errors[v].dot(errors[v]);
+            corners += errors[v].rows;
+            checked.viewErrors.emplace_back(viewError(views[v], errors[v], files, false));
+        }
+        checked.reprojError = std::sqrt(squaredError / std::max(corners, 1));
+
+        const double drift{checked.reprojError - previous.reprojError};
+        std::cout << "  RMS with the previous calibration: " << checked.reprojError << " px, previously: " <<
+            previous.reprojError << " px, drift: " << drift << " px\n";
+
+        if (drift > GlobalVariables::quickCheckMaxDrift) {
+            std::cout << "  Drift exceeds " << GlobalVariables::quickCheckMaxDrift <<
+                " px, run a full mono calibration for this camera\n";
+            return false;
+        }
+
+        calibData = std::move(checked);
+        return true;
+    }
+
+
+    void monoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
+                       std::vector<CamData>& camDatas,
+                       const Config::FileConfig& fileConfig,
+                       const std::filesystem::path& jobPath,
+                       const MonoCalibrationOptions& options) {
+        std::vector<std::filesystem::path> files;
+        // Get all camera directories in the given job path, together with the file indexes.
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
+
+        const cv::aruco::CharucoBoard& board{charucoDetector.getBoard()};
+        const cv::Size boardSize{board.getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+
+        const auto detections{
+            detectBoards(charucoDetector,
+                         cams,
+                         files,
+                         std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin),
+                         fileConfig.detectionConfig)
+        };
 
+        for (auto i{0}; i < static_cast<int>(cams.size()); ++i) {
+            auto& info{camDatas[i].info};
+            std::vector<MonoView> views;
+
+            for (std::size_t f{0}; f < files.size(); ++f) {
+                const auto& results{detections[i][f]};
                 if (!results.boardFound) continue;
 
-                board.matchImagePoints(results.charucoCorners,
-                                       results.charucoIds,
-                                       objPoints,
-                                       imgPoints);
-                allObjPoints.push_back(objPoints);
-                allImgPoints.push_back(imgPoints);
+                MonoView view{f};
+                board.matchImagePoints(results.charucoCorners, results.charucoIds, view.objPoints, view.imgPoints);
+                views.emplace_back(std::move(view));
             }
 
-            camDatas[i].info.calibData.reprojError = cv::calibrateCamera(allObjPoints,
-                                                                         allImgPoints,
-                                                                         cv::Size(camDatas[i].info.resolution.width,
-                                                                             camDatas[i].info.resolution.height),
-                                                                         camDatas[i].info.calibData.cameraMatrix,
-                                                                         camDatas[i].info.calibData.distCoeffs,
-                                                                         camDatas[i].info.calibData.rvecs,
-                                                                         camDatas[i].info.calibData.tvecs);
+            auto flags{0};
+            if (options.warmStart || options.quickCheck) {
+                const auto previous{findPreviousCalibration(jobPath, fileConfig, info, options.previousJobId)};
+                if (!previous)
+                    throw std::runtime_error("No previous calibration found for camera: " + info.camName +
+                                             " with ID: " + std::to_string(info.camIndexId));
+
+                std::cout << "Using calibration of job " << previous->first << " for cam: " << info.camName << "\n";
+                if (options.quickCheck) {
+                    if (quickCheck(views, info.calibData, previous->second, files))
+                        std::cout << "Calibration of cam: " << info.camName << "\n  ID: " << info.camIndexId <<
+                            ", still valid \n";
+                    continue;
+                }
+
+                // Seed the solver with the previous intrinsics.
+                info.calibData.cameraMatrix = previous->second.cameraMatrix.clone();
+                info.calibData.distCoeffs = previous->second.distCoeffs.clone();
+                flags = cv::CALIB_USE_INTRINSIC_GUESS;
+            }
 
-            std::cout << "Calibration of cam: " << camDatas[i].info.camName << "\n  ID: " << camDatas[i].info.camIndexId
-                << ", done \n";
+            info.calibData.reprojError = options.benchmark
+                                             ? benchmarkSolvers(views, info.resolution, info.calibData, flags,
+                                                                options.solver)
+                                             : calibrateViews(views, info.resolution, info.calibData, flags,
+                                                              options.solver);
+            rejectOutliers(views, info.resolution, info.calibData, files, options);
+            if (options.bootstrapRuns > 0)
+                bootstrapMono(views, info.resolution, info.calibData, options.bootstrapRuns, options.solver);
 
-            i++;
+            std::cout << "Calibration of cam: " << info.camName << "\n  ID: " << info.camIndexId << ", RMS: " <<
+                info.calibData.reprojError << " px, views: " << views.size() << ", done \n";
         }
     }
 
@@ -135,90 +980,603 @@ namespace YACCP::Calibration {
                                  std::vector<CamData>& camDatas,
                                  std::vector<StereoCalibData>& stereoCalibDatas,
                                  const Config::FileConfig& fileConfig,
-                                 const std::filesystem::path& jobPath) {
-        std::vector<std::filesystem::path> cams;
+                                 const std::filesystem::path& jobPath,
+                                 const int bootstrapRuns) {
         std::vector<std::filesystem::path> files;
+        // Get all camera directories in the given job path, together with the file indexes.
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
         stereoCalibDatas.clear();
+        checkMonoCalibration(camDatas);
 
-        // Get all camera directories in the given job path.
-        getCamDirs(cams, camDatas, jobPath);
-        // Get all the file indexes, only a single camera directory needs to be looked at,
-        // since the filenames are the same across the multiple cameras.
-        getImages(cams.front(), files);
+        const cv::aruco::CharucoBoard& board{charucoDetector.getBoard()};
+        const cv::Size boardSize{board.getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
 
-        cv::aruco::CharucoBoard board{charucoDetector.getBoard()};
-        cv::Size boardSize = board.getChessboardSize();
-        int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+        // Detect once, every pair reuses the same detections.
+        const auto detections{
+            detectBoards(charucoDetector,
+                         cams,
+                         files,
+                         std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin),
+                         fileConfig.detectionConfig)
+        };
 
-        for (auto& [info, runtimeData] : camDatas) {
-            if (info.calibData.cameraMatrix.empty() || info.calibData.distCoeffs.empty())
-                throw std::runtime_error("Camera: " + info.camName + " with ID: " + std::to_string(info.camIndexId) +
-                                         "\nIs missing its camera matrix or distance coefficients vector, did you run mono calibration?");
+        for (auto left{0}; left < static_cast<int>(cams.size()); ++left) {
+            for (auto right{left + 1}; right < static_cast<int>(cams.size()); ++right) {
+                StereoCalibData stereoCalibData;
+
+                std::cout << "Starting stereo calibration for cameras " + std::to_string(left) + " and " +
+                    std::to_string(right) + "\n";
+
+                const double rms{
+                    stereoCalibratePair(board, detections, camDatas, left, right, stereoCalibData, bootstrapRuns)
+                };
+                std::cout << "  RMS: " << rms << " px\n";
+
+                stereoCalibDatas.emplace_back(stereoCalibData);
+            }
+        }
+    }
+
+
+    static cv::Matx33d skew(const cv::Vec3d& v) {
+        return {0., -v[2], v[1], v[2], 0., -v[0], -v[1], v[0], 0.};
+    }
+
+
+    void jointCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
+                        std::vector<CamData>& camDatas,
+                        std::vector<StereoCalibData>& stereoCalibDatas,
+                        const Config::FileConfig& fileConfig,
+                        const std::filesystem::path& jobPath,
+                        const bool fixIntrinsics) {
+        const auto startTime{std::chrono::steady_clock::now()};
+        std::vector<std::filesystem::path> files;
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
+        stereoCalibDatas.clear();
+        checkMonoCalibration(camDatas);
+
+        const cv::aruco::CharucoBoard& board{charucoDetector.getBoard()};
+        const cv::Size boardSize{board.getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+        const auto numCams{static_cast<int>(cams.size())};
+        const auto numFiles{static_cast<int>(files.size())};
+
+        const auto detections{
+            detectBoards(charucoDetector,
+                         cams,
+                         files,
+                         std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin),
+                         fileConfig.detectionConfig)
+        };
+
+        // Initial board to camera poses from the mono intrinsics.
+        std::vector<RigObservation> observations;
+        std::vector boardPoses(numCams, std::vector<std::optional<cv::Affine3d> >(numFiles));
+        std::vector cornerCounts(numCams, std::vector<int>(numFiles));
+        std::vector observationIds(numCams, std::vector<int>(numFiles, -1));
+
+        for (auto c{0}; c < numCams; ++c) {
+            const auto& calibData{camDatas[c].info.calibData};
+            for (auto f{0}; f < numFiles; ++f) {
+                const auto& results{detections[c][f]};
+                if (!results.boardFound) continue;
+
+                RigObservation observation{c, f};
+                board.matchImagePoints(results.charucoCorners,
+                                       results.charucoIds,
+                                       observation.objPoints,
+                                       observation.imgPoints);
+                if (observation.objPoints.size() < 6) continue;
+
+                cv::Vec3d rvec;
+                cv::Vec3d tvec;
+                if (!cv::solvePnP(observation.objPoints,
+                                  observation.imgPoints,
+                                  calibData.cameraMatrix,
+                                  calibData.distCoeffs,
+                                  rvec,
+                                  tvec)) {
+                    continue;
+                }
+
+                boardPoses[c][f] = cv::Affine3d(rvec, tvec);
+                cornerCounts[c][f] = static_cast<int>(observation.objPoints.size());
+                observationIds[c][f] = static_cast<int>(observations.size());
+                observations.emplace_back(std::move(observation));
+            }
+        }
+
+        // Chain the camera poses from the reference camera along the pairs with the most shared corners.
+        std::vector<std::optional<cv::Affine3d> > camPoses(numCams);
+        camPoses.front() = cv::Affine3d::Identity();
+        for (const auto& [from, to, overlap] : maximumSpanningTree(countPairOverlap(detections), camDatas)) {
+            // Use the shared view where the worst of both detections has the most corners.
+            auto bestFrame{-1};
+            auto bestCorners{0};
+            for (auto f{0}; f < numFiles; ++f) {
+                if (!boardPoses[from][f] || !boardPoses[to][f]) continue;
+
+                const int corners{std::min(cornerCounts[from][f], cornerCounts[to][f])};
+                if (corners > bestCorners) {
+                    bestCorners = corners;
+                    bestFrame = f;
+                }
+            }
+
+            if (bestFrame < 0)
+                throw std::runtime_error("Camera: " + camDatas[to].info.camName + " with ID: " +
+                                         std::to_string(camDatas[to].info.camIndexId) +
+                                         "\nHas no board pose in a view shared with the rig, it can not be added.");
+
+            camPoses[to] = *boardPoses[to][bestFrame] * boardPoses[from][bestFrame]->inv() * *camPoses[from];
+        }
+
+        // Initial board to reference poses, taken from the camera that saw most of the board.
+        RigParameters rigParameters;
+        std::vector frameIds(numFiles, -1);
+        for (auto f{0}; f < numFiles; ++f) {
+            auto bestCam{-1};
+            for (auto c{0}; c < numCams; ++c) {
+                if (boardPoses[c][f] && (bestCam < 0 || cornerCounts[c][f] > cornerCounts[bestCam][f])) bestCam = c;
+            }
+            if (bestCam < 0) continue;
+
+            const cv::Affine3d framePose{camPoses[bestCam]->inv() * *boardPoses[bestCam][f]};
+            const cv::Vec3d rvec{framePose.rvec()};
+            const cv::Vec3d tvec{framePose.translation()};
+            frameIds[f] = static_cast<int>(rigParameters.frames.size());
+            rigParameters.frames.emplace_back(rvec[0], rvec[1], rvec[2], tvec[0], tvec[1], tvec[2]);
+        }
+        for (auto& observation : observations) observation.frameId = frameIds[observation.frameId];
+
+        for (auto c{0}; c < numCams; ++c) {
+            const auto& calibData{camDatas[c].info.calibData};
+            const cv::Mat distCoeffs{calibData.distCoeffs.reshape(1, 1)};
+            const cv::Vec3d rvec{camPoses[c]->rvec()};
+            const cv::Vec3d tvec{camPoses[c]->translation()};
+
+            CamVec cam{CamVec::zeros()};
+            cam[0] = calibData.cameraMatrix.at<double>(0, 0);
+            cam[1] = calibData.cameraMatrix.at<double>(1, 1);
+            cam[2] = calibData.cameraMatrix.at<double>(0, 2);
+            cam[3] = calibData.cameraMatrix.at<double>(1, 2);
+            // Only the five coefficient model is refined, higher order terms are dropped.
+            for (auto k{0}; k < std::min(distCoeffs.cols, 5); ++k) cam[4 + k] = distCoeffs.at<double>(0, k);
+            for (auto k{0}; k < 3; ++k) {
+                cam[intrinsicParams + k] = rvec[k];
+                cam[intrinsicParams + 3 + k] = tvec[k];
+            }
+            rigParameters.cams.emplace_back(cam);
+        }
+
+        std::cout << "Starting joint calibration of " << numCams << " cameras with " << observations.size() <<
+            " observations\n";
+
+        BundleAdjustmentOptions options;
+        options.fixIntrinsics = fixIntrinsics;
+        const BundleAdjustmentResult result{bundleAdjust(observations, rigParameters, options)};
+
+        // Write the refined rig back to the cameras.
+        std::vector<cv::Matx33d> rotations(numCams);
+        std::vector<cv::Vec3d> translations(numCams);
+        for (auto c{0}; c < numCams; ++c) {
+            const CamVec& cam{rigParameters.cams[c]};
+            auto& calibData{camDatas[c].info.calibData};
+            const cv::Affine3d camPose{
+                cv::Vec3d(cam[intrinsicParams], cam[intrinsicParams + 1], cam[intrinsicParams + 2]),
+                cv::Vec3d(cam[intrinsicParams + 3], cam[intrinsicParams + 4], cam[intrinsicParams + 5])
+            };
+            rotations[c] = camPose.rotation();
+            translations[c] = camPose.translation();
+
+            calibData.cameraMatrix = (cv::Mat_<double>(3, 3) << cam[0], 0., cam[2], 0., cam[1], cam[3], 0., 0., 1.);
+            calibData.distCoeffs = (cv::Mat_<double>(1, 5) << cam[4], cam[5], cam[6], cam[7], cam[8]);
+            calibData.reprojError = result.camRms[c];
+            calibData.rigRotation = cv::Mat(rotations[c]).clone();
+            calibData.rigTranslation = cv::Mat(translations[c]).clone();
+
+            calibData.rvecs.clear();
+            calibData.tvecs.clear();
+            for (auto f{0}; f < numFiles; ++f) {
+                if (observationIds[c][f] < 0) continue;
+
+                const cv::Vec6d& frame{rigParameters.frames[frameIds[f]]};
+                const cv::Affine3d viewPose{
+                    camPose * cv::Affine3d(cv::Vec3d(frame[0], frame[1], frame[2]),
+                                           cv::Vec3d(frame[3], frame[4], frame[5]))
+                };
+                calibData.rvecs.emplace_back(cv::Mat(viewPose.rvec()).clone());
+                calibData.tvecs.emplace_back(cv::Mat(viewPose.translation()).clone());
+            }
         }
 
-        for (auto left{0}; left < cams.size(); ++left) {
-            for (auto right{left + 1}; right < cams.size(); ++right) {
-                std::vector<std::vector<cv::Point3f> > allObjPoints;
-                std::vector<std::vector<cv::Point2f> > allImgPointsLeft, allImgPointsRight;
+        // Every pair follows from the rig, so all pairs are consistent with each other.
+        for (auto left{0}; left < numCams; ++left) {
+            for (auto right{left + 1}; right < numCams; ++right) {
+                const cv::Matx33d rotation{rotations[right] * rotations[left].t()};
+                const cv::Vec3d translation{translations[right] - rotation * translations[left]};
+                const cv::Matx33d essential{skew(translation) * rotation};
+                const cv::Matx33d cameraMatrixLeft{camDatas[left].info.calibData.cameraMatrix};
+                const cv::Matx33d cameraMatrixRight{camDatas[right].info.calibData.cameraMatrix};
+                const cv::Matx33d fundamental{cameraMatrixRight.inv().t() * essential * cameraMatrixLeft.inv()};
+
                 StereoCalibData stereoCalibData;
                 stereoCalibData.camLeftId = left;
                 stereoCalibData.camRightId = right;
+                stereoCalibData.rotationMatrix = cv::Mat(rotation).clone();
+                stereoCalibData.translationMatrix = cv::Mat(translation).clone();
+                stereoCalibData.essentialMatrix = cv::Mat(essential).clone();
+                stereoCalibData.fundamentalMatrix = cv::Mat(fundamental).clone();
+                stereoCalibDatas.emplace_back(stereoCalibData);
+            }
+        }
 
-                for (auto& file : files) {
-                    // TODO: add progressbar for image loading & detection.
-                    std::vector<cv::Point3f> objPointsLeft, objPointsRight;
-                    std::vector<cv::Point2f> imgPointsLeft, imgPointsRight;
-                    std::vector<cv::Point2f> overlapCornersLeft, overlapCornersRight;
-                    std::vector<int> overlapIds;
-
-                    cv::Mat imgLeft{cv::imread((cams[left] / file).string(), cv::IMREAD_GRAYSCALE)};
-                    cv::Mat imgRight{cv::imread((cams[right] / file).string(), cv::IMREAD_GRAYSCALE)};
-
-                    Utility::CharucoResults resultsLeft{
-                        Utility::findBoard(
-                            charucoDetector,
-                            imgLeft,
-                            std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin))
-                    };
-                    Utility::CharucoResults resultsRight{
-                        Utility::findBoard(
-                            charucoDetector,
-                            imgRight,
-                            std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin))
-                    };
+        const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - startTime};
+        std::cout << "Joint calibration done in " << duration.count() << " s, " << result.iterations <<
+            " iterations, RMS: " << result.rms << " px\n";
+        for (auto c{0}; c < numCams; ++c) {
+            std::cout << "  Cam: " << camDatas[c].info.camName << ", ID: " << camDatas[c].info.camIndexId <<
+                ", RMS: " << result.camRms[c] << " px\n";
+        }
+    }
+
+
+    void spanningTreeStereoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
+                                     std::vector<CamData>& camDatas,
+                                     std::vector<StereoCalibData>& stereoCalibDatas,
+                                     const Config::FileConfig& fileConfig,
+                                     const std::filesystem::path& jobPath,
+                                     const int loopClosures,
+                                     const int bootstrapRuns) {
+        std::vector<std::filesystem::path> files;
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
+        stereoCalibDatas.clear();
+        checkMonoCalibration(camDatas);
+
+        const cv::aruco::CharucoBoard& board{charucoDetector.getBoard()};
+        const cv::Size boardSize{board.getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+        const auto numCams{static_cast<int>(cams.size())};
+
+        // Detect once, every pair reuses the same detections.
+        const auto detections{
+            detectBoards(charucoDetector,
+                         cams,
+                         files,
+                         std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin),
+                         fileConfig.detectionConfig)
+        };
+        auto overlap{countPairOverlap(detections)};
+        const std::vector<CameraPair> edges{maximumSpanningTree(overlap, camDatas)};
+
+        // Pose from the reference camera to every camera, chained along the tree.
+        std::vector<cv::Matx33d> rotations(numCams, cv::Matx33d::eye());
+        std::vector<cv::Vec3d> translations(numCams);
 
-                    if (!resultsLeft.boardFound || !resultsRight.boardFound) continue;
+        for (const auto& [from, to, pairOverlap] : edges) {
+            StereoCalibData stereoCalibData;
+            const int left{std::min(from, to)};
+            const int right{std::max(from, to)};
 
-                    filterByOverlapIds(resultsLeft, resultsRight, overlapCornersLeft, overlapCornersRight, overlapIds);
+            std::cout << "Starting stereo calibration for cameras " << left << " and " << right << ", " << pairOverlap
+                << " shared corners\n";
+            const double rms{
+                stereoCalibratePair(board, detections, camDatas, left, right, stereoCalibData, bootstrapRuns)
+            };
+            std::cout << "  RMS: " << rms << " px\n";
 
-                    board.matchImagePoints(overlapCornersLeft, overlapIds, objPointsLeft, imgPointsLeft);
-                    board.matchImagePoints(overlapCornersRight, overlapIds, objPointsRight, imgPointsRight);
+            // The pair maps points from the left to the right camera.
+            const cv::Matx33d rotation{stereoCalibData.rotationMatrix};
+            const cv::Vec3d translation{stereoCalibData.translationMatrix.reshape(1, 3)};
+            if (from == left) {
+                rotations[to] = rotation * rotations[from];
+                translations[to] = rotation * translations[from] + translation;
+            } else {
+                rotations[to] = rotation.t() * rotations[from];
+                translations[to] = rotation.t() * (translations[from] - translation);
+            }
+
+            stereoCalibDatas.emplace_back(stereoCalibData);
+            overlap[from][to] = overlap[to][from] = 0;
+        }
 
-                    allObjPoints.emplace_back(objPointsLeft);
-                    allImgPointsLeft.emplace_back(imgPointsLeft);
-                    allImgPointsRight.emplace_back(imgPointsRight);
+        for (auto c{0}; c < numCams; ++c) {
+            camDatas[c].info.calibData.rigRotation = cv::Mat(rotations[c]).clone();
+            camDatas[c].info.calibData.rigTranslation = cv::Mat(translations[c]).clone();
+        }
+
+        // Calibrate the strongest remaining pairs directly and compare them against the chained result.
+        for (auto closure{0}; closure < loopClosures; ++closure) {
+            CameraPair best{-1, -1, 0};
+            for (auto left{0}; left < numCams; ++left) {
+                for (auto right{left + 1}; right < numCams; ++right) {
+                    if (overlap[left][right] > best.overlap) best = {left, right, overlap[left][right]};
                 }
+            }
+            if (best.from < 0) break;
+            overlap[best.from][best.to] = 0;
 
-                std::cout << "Starting stereo calibration for cameras " + std::to_string(left) + " and " +
-                    std::to_string(right) + "\n";
+            StereoCalibData stereoCalibData;
+            const double rms{stereoCalibratePair(board, detections, camDatas, best.from, best.to, stereoCalibData)};
 
-                auto calibFlags{cv::CALIB_FIX_INTRINSIC};
-                (void)cv::stereoCalibrate(allObjPoints,
-                                          allImgPointsLeft,
-                                          allImgPointsRight,
-                                          camDatas[left].info.calibData.cameraMatrix,
-                                          camDatas[left].info.calibData.distCoeffs,
-                                          camDatas[right].info.calibData.cameraMatrix,
-                                          camDatas[right].info.calibData.distCoeffs,
-                                          cv::Size(0, 0),
-                                          stereoCalibData.rotationMatrix,
-                                          stereoCalibData.translationMatrix,
-                                          stereoCalibData.essentialMatrix,
-                                          stereoCalibData.fundamentalMatrix,
-                                          cv::noArray(),
-                                          calibFlags);
-                stereoCalibDatas.emplace_back(stereoCalibData);
+            const cv::Matx33d chainedRotation{rotations[best.to] * rotations[best.from].t()};
+            const cv::Vec3d chainedTranslation{translations[best.to] - chainedRotation * translations[best.from]};
+            const cv::Matx33d rotation{stereoCalibData.rotationMatrix};
+            const cv::Vec3d translation{stereoCalibData.translationMatrix.reshape(1, 3)};
+
+            const cv::Matx33d rotationError{rotation * chainedRotation.t()};
+            const double cosAngle{std::clamp((cv::trace(rotationError) - 1.) / 2., -1., 1.)};
+            const double angleError{std::acos(cosAngle) * 180. / CV_PI};
+            const double translationError{cv::norm(translation - chainedTranslation)};
+
+            std::cout << "Loop closure cameras " << best.from << " and " << best.to << ", RMS: " << rms <<
+                " px\n  Rotation difference: " << angleError << " deg, translation difference: " <<
+                translationError << " (" << 100. * translationError / cv::norm(translation) << " %)\n";
+
+            stereoCalibDatas.emplace_back(stereoCalibData);
+        }
+    }
+
+
+    void checkDetection(const cv::aruco::CharucoDetector& charucoDetector,
+                        std::vector<CamData>& camDatas,
+                        const Config::FileConfig& fileConfig,
+                        const std::filesystem::path& jobPath,
+                        const int pyramidLevels,
+                        const int tiles) {
+        Config::DetectionConfig fullConfig{fileConfig.detectionConfig};
+        fullConfig.pyramidLevels = 0;
+        fullConfig.tiles = 1;
+
+        Config::DetectionConfig checkedConfig{fileConfig.detectionConfig};
+        if (pyramidLevels > 0) {
+            checkedConfig.pyramidLevels = pyramidLevels;
+            checkedConfig.tiles = 1;
+        } else if (tiles > 1) {
+            checkedConfig.pyramidLevels = 0;
+            checkedConfig.tiles = tiles;
+        }
+        if (checkedConfig.pyramidLevels == 0 && checkedConfig.tiles <= 1)
+            throw std::runtime_error("This job detects in a single full resolution pass, give the detection to check "
+                                     "with --pyramid-levels or --tiles");
+
+        std::vector<std::filesystem::path> files;
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
+
+        const cv::Size boardSize{charucoDetector.getBoard().getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+        const int cornerMin{
+            static_cast<int>(std::floor(static_cast<float>(cornerAmount) * fileConfig.detectionConfig.cornerMin))
+        };
+
+        const auto fullStart{std::chrono::steady_clock::now()};
+        const auto fullDetections{detectBoards(charucoDetector, cams, files, cornerMin, fullConfig)};
+        const std::chrono::duration<double> fullDuration{std::chrono::steady_clock::now() - fullStart};
+
+        const auto checkedStart{std::chrono::steady_clock::now()};
+        const auto checkedDetections{detectBoards(charucoDetector, cams, files, cornerMin, checkedConfig)};
+        const std::chrono::duration<double> checkedDuration{std::chrono::steady_clock::now() - checkedStart};
+
+        if (checkedConfig.tiles > 1) {
+            std::cout << "Tiled detection with " << checkedConfig.tiles << "x" << checkedConfig.tiles <<
+                " tiles against full resolution detection\n";
+        } else {
+            std::cout << "Pyramid detection with " << checkedConfig.pyramidLevels <<
+                " levels against full resolution detection\n";
+        }
+        for (std::size_t c{0}; c < cams.size(); ++c) {
+            int fullBoards{0};
+            int checkedBoards{0};
+            std::size_t sharedCorners{0};
+            double sumDifference{0.};
+            double maxDifference{0.};
+
+            for (std::size_t f{0}; f < files.size(); ++f) {
+                const auto& resultsFull{fullDetections[c][f]};
+                const auto& resultsChecked{checkedDetections[c][f]};
+                fullBoards += resultsFull.boardFound;
+                checkedBoards += resultsChecked.boardFound;
+                if (!resultsFull.boardFound || !resultsChecked.boardFound) continue;
+
+                std::vector<cv::Point2f> cornersFull;
+                std::vector<cv::Point2f> cornersChecked;
+                std::vector<int> ids;
+                filterByOverlapIds(resultsFull, resultsChecked, cornersFull, cornersChecked, ids);
+                for (std::size_t i{0}; i < ids.size(); ++i) {
+                    const double difference{cv::norm(cornersFull[i] - cornersChecked[i])};
+                    sumDifference += difference;
+                    maxDifference = std::max(maxDifference, difference);
+                }
+                sharedCorners += ids.size();
             }
+
+            std::cout << "  Cam: " << camDatas[c].info.camName << ", boards: " << fullBoards << " full, " <<
+                checkedBoards << " checked\n    Corner difference over " << sharedCorners << " corners, mean: " <<
+                (sharedCorners > 0 ? sumDifference / static_cast<double>(sharedCorners) : 0.) << " px, max: " <<
+                maxDifference << " px\n";
+        }
+        std::cout << "  Detection time including image loading, full: " << fullDuration.count() << " s, checked: " <<
+            checkedDuration.count() << " s\n";
+    }
+
+
+    std::filesystem::path remapTablePath(const std::filesystem::path& jobPath, const int camId) {
+        return jobPath / GlobalVariables::remapDirName /
+            ("cam_" + std::to_string(camId) + GlobalVariables::remapFileExtension);
+    }
+
+
+    std::filesystem::path stereoRemapTablePath(const std::filesystem::path& jobPath,
+                                               const int camLeftId,
+                                               const int camRightId,
+                                               const bool isLeft) {
+        return jobPath / GlobalVariables::remapDirName /
+            ("pair_" + std::to_string(camLeftId) + "_" + std::to_string(camRightId) + (isLeft ? "_left" : "_right") +
+             GlobalVariables::remapFileExtension);
+    }
+
+
+    void exportRemapTables(std::vector<CamData>& camDatas,
+                           std::vector<StereoCalibData>& stereoCalibDatas,
+                           const std::filesystem::path& jobPath) {
+        checkMonoCalibration(camDatas);
+        std::filesystem::create_directories(jobPath / GlobalVariables::remapDirName);
+
+        // Rectify every pair, the rectified images of a pair share the resolution of the left camera.
+        std::vector<StereoCalibData*> pairs;
+        for (auto& stereoCalibData : stereoCalibDatas) {
+            if (stereoCalibData.rotationMatrix.empty()) continue;
+
+            const auto& left{camDatas[stereoCalibData.camLeftId].info};
+            const auto& right{camDatas[stereoCalibData.camRightId].info};
+            cv::stereoRectify(left.calibData.cameraMatrix,
+                              left.calibData.distCoeffs,
+                              right.calibData.cameraMatrix,
+                              right.calibData.distCoeffs,
+                              left.resolution,
+                              stereoCalibData.rotationMatrix,
+                              stereoCalibData.translationMatrix,
+                              stereoCalibData.rectificationLeft,
+                              stereoCalibData.rectificationRight,
+                              stereoCalibData.projectionLeft,
+                              stereoCalibData.projectionRight,
+                              stereoCalibData.disparityToDepth,
+                              cv::CALIB_ZERO_DISPARITY,
+                              0.);
+            pairs.emplace_back(&stereoCalibData);
+        }
+
+        // One table per camera followed by two per pair, every table is computed and written independently.
+        const auto numCams{static_cast<int>(camDatas.size())};
+        const auto numTables{numCams + 2 * static_cast<int>(pairs.size())};
+        std::mutex m;
+        std::exception_ptr e{};
+
+        cv::parallel_for_(cv::Range(0, numTables),
+                          [&](const cv::Range& range) {
+                              for (auto table{range.start}; table < range.end; ++table) {
+                                  try {
+                                      cv::Mat map1;
+                                      cv::Mat map2;
+
+                                      if (table < numCams) {
+                                          const auto& info{camDatas[table].info};
+                                          cv::initUndistortRectifyMap(info.calibData.cameraMatrix,
+                                                                      info.calibData.distCoeffs,
+                                                                      cv::noArray(),
+                                                                      info.calibData.cameraMatrix,
+                                                                      info.resolution,
+                                                                      CV_16SC2,
+                                                                      map1,
+                                                                      map2);
+                                          RemapTable::write(remapTablePath(jobPath, table), map1, map2);
+                                          continue;
+                                      }
+
+                                      const StereoCalibData& pair{*pairs[(table - numCams) / 2]};
+                                      const bool isLeft{(table - numCams) % 2 == 0};
+                                      const auto& info{camDatas[isLeft ? pair.camLeftId : pair.camRightId].info};
+                                      cv::initUndistortRectifyMap(info.calibData.cameraMatrix,
+                                                                  info.calibData.distCoeffs,
+                                                                  isLeft ? pair.rectificationLeft : pair.rectificationRight,
+                                                                  isLeft ? pair.projectionLeft : pair.projectionRight,
+                                                                  camDatas[pair.camLeftId].info.resolution,
+                                                                  CV_16SC2,
+                                                                  map1,
+                                                                  map2);
+                                      RemapTable::write(stereoRemapTablePath(jobPath,
+                                                                             pair.camLeftId,
+                                                                             pair.camRightId,
+                                                                             isLeft),
+                                                        map1,
+                                                        map2);
+                                  }
+                                  catch (...) {
+                                      std::scoped_lock lock{m};
+                                      if (!e) e = std::current_exception();
+                                  }
+                              }
+                          });
+
+        if (e) std::rethrow_exception(e);
+
+        std::cout << "Exported " << numTables << " remap tables to " << (jobPath / GlobalVariables::remapDirName).string()
+            << "\n";
+    }
+
+
+    static std::unique_ptr<RemapTable> loadRemapTable(const std::filesystem::path& path) {
+        if (!std::filesystem::exists(path))
+            throw std::runtime_error("Remap table " + path.string() + " does not exist, did you run calibrate maps?");
+
+        return std::make_unique<RemapTable>(path);
+    }
+
+
+    void undistortImages(std::vector<CamData>& camDatas,
+                         std::vector<StereoCalibData>& stereoCalibDatas,
+                         const std::filesystem::path& jobPath) {
+        std::vector<std::filesystem::path> files;
+        const auto cams{getOrderedCamDirs(camDatas, jobPath, files)};
+        const auto numFiles{static_cast<int>(files.size())};
+
+        // Whole images are processed in parallel here, the tiles of a single remap then run on the same thread.
+        for (auto c{0}; c < static_cast<int>(cams.size()); ++c) {
+            const auto remapTable{loadRemapTable(remapTablePath(jobPath, c))};
+            const std::filesystem::path outPath{jobPath / "images" / "undistorted" / cams[c].filename()};
+            (void)std::filesystem::create_directories(outPath);
+
+            cv::parallel_for_(cv::Range(0, numFiles),
+                              [&](const cv::Range& range) {
+                                  cv::Mat undistorted;
+                                  for (auto f{range.start}; f < range.end; ++f) {
+                                      const cv::Mat img{cv::imread((cams[c] / files[f]).string(), cv::IMREAD_UNCHANGED)};
+                                      if (img.empty()) continue;
+
+                                      remapTable->apply(img, undistorted);
+                                      (void)cv::imwrite((outPath / files[f]).string(), undistorted);
+                                  }
+                              });
+
+            std::cout << "Undistorted " << numFiles << " images of cam: " << camDatas[c].info.camName << "\n";
+        }
+
+        for (const auto& stereoCalibData : stereoCalibDatas) {
+            if (stereoCalibData.rectificationLeft.empty()) continue;
+
+            const int left{stereoCalibData.camLeftId};
+            const int right{stereoCalibData.camRightId};
+            const auto remapTableLeft{loadRemapTable(stereoRemapTablePath(jobPath, left, right, true))};
+            const auto remapTableRight{loadRemapTable(stereoRemapTablePath(jobPath, left, right, false))};
+            const std::filesystem::path outPath{
+                jobPath / "images" / "rectified" / ("pair_" + std::to_string(left) + "_" + std::to_string(right))
+            };
+            (void)std::filesystem::create_directories(outPath);
+
+            // Both sides are written next to each other with horizontal lines, matching features should lie on a line.
+            cv::parallel_for_(cv::Range(0, numFiles),
+                              [&](const cv::Range& range) {
+                                  cv::Mat rectifiedLeft;
+                                  cv::Mat rectifiedRight;
+                                  cv::Mat sideBySide;
+                                  for (auto f{range.start}; f < range.end; ++f) {
+                                      const cv::Mat imgLeft{cv::imread((cams[left] / files[f]).string(), cv::IMREAD_COLOR)};
+                                      const cv::Mat imgRight{cv::imread((cams[right] / files[f]).string(), cv::IMREAD_COLOR)};
+                                      if (imgLeft.empty() || imgRight.empty()) continue;
+
+                                      remapTableLeft->apply(imgLeft, rectifiedLeft);
+                                      remapTableRight->apply(imgRight, rectifiedRight);
+                                      cv::hconcat(rectifiedLeft, rectifiedRight, sideBySide);
+                                      for (auto y{GlobalVariables::rectifiedLineSpacing}; y < sideBySide.rows;
+                                           y += GlobalVariables::rectifiedLineSpacing) {
+                                          cv::line(sideBySide, {0, y}, {sideBySide.cols - 1, y}, {0., 255., 0.}, 1);
+                                      }
+                                      (void)cv::imwrite((outPath / files[f]).string(), sideBySide);
+                                  }
+                              });
+
+            std::cout << "Rectified " << numFiles << " image pairs of cameras " << left << " and " << right << "\n";
         }
     }
-}
\ No newline at end of file
+}
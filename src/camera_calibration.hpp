@@ -9,17 +9,121 @@
 #include <opencv2/objdetect/charuco_detector.hpp>
 
 namespace YACCP::Calibration {
+    /**
+     * @brief Solver used for mono calibration, the native solver is the multi-threaded bundle adjustment.
+     */
+    enum class MonoSolver {
+        OpenCv,
+        Native
+    };
+
+    /**
+     * @param outlierRounds Maximum amount of reject and re-solve rounds, 0 disables outlier rejection.
+     * @param outlierThreshold Corners further than this many robust standard deviations above the median are rejected.
+     * @param warmStart Seed the solver with the most recent calibration of the same camera in another job.
+     * @param quickCheck Only verify the most recent calibration of the same camera against the new detections.
+     * @param previousJobId Job to take the previous calibration from, the newest matching job when empty.
+     * @param bootstrapRuns Amount of bootstrap resamples used to estimate the uncertainty, 0 disables it.
+     * @param solver Solver used for every calibration of the views.
+     * @param benchmark Also run the other solver on the initial calibration and report timing and differences.
+     */
+    struct MonoCalibrationOptions {
+        int outlierRounds;
+        double outlierThreshold;
+        bool warmStart;
+        bool quickCheck;
+        std::string previousJobId;
+        int bootstrapRuns;
+        MonoSolver solver;
+        bool benchmark;
+    };
+
     void monoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
                        std::vector<CamData>& camDatas,
                        const Config::FileConfig& fileConfig,
-                       const std::filesystem::path& jobPath);
+                       const std::filesystem::path& jobPath,
+                       const MonoCalibrationOptions& options);
 
+    /**
+     * @param bootstrapRuns Amount of bootstrap resamples per pair used to estimate the uncertainty, 0 disables it.
+     */
     void pairWiseStereoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
                                  std::vector<CamData>& camDatas,
                                  std::vector<StereoCalibData>& stereoCalibDatas,
                                  const Config::FileConfig& fileConfig,
-                                 const std::filesystem::path& jobPath);
+                                 const std::filesystem::path& jobPath,
+                                 int bootstrapRuns);
+
+    /**
+     * @brief Stereo calibrate only the camera pairs of a maximum overlap spanning tree.
+     *
+     * The N - 1 pairs are chained into poses relative to the first camera. Optionally the strongest remaining pairs are
+     * calibrated as loop closures, their difference with the chained poses is reported as a consistency check.
+     */
+    void spanningTreeStereoCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
+                                     std::vector<CamData>& camDatas,
+                                     std::vector<StereoCalibData>& stereoCalibDatas,
+                                     const Config::FileConfig& fileConfig,
+                                     const std::filesystem::path& jobPath,
+                                     int loopClosures,
+                                     int bootstrapRuns);
+
+    /**
+     * @brief Calibrate all cameras at once with a bundle adjustment over all views.
+     *
+     * Requires mono calibration to initialise the intrinsics, the first camera is used as the reference of the rig.
+     * Afterwards every camera pair is filled from the single consistent rig.
+     */
+    void jointCalibrate(const cv::aruco::CharucoDetector& charucoDetector,
+                        std::vector<CamData>& camDatas,
+                        std::vector<StereoCalibData>& stereoCalibDatas,
+                        const Config::FileConfig& fileConfig,
+                        const std::filesystem::path& jobPath,
+                        bool fixIntrinsics);
+
+    /**
+     * @brief Compare the pyramid or tiled detection with the full resolution detection on all verified images.
+     *
+     * Reports per camera the boards found by both detections, the mean and maximum distance between the ChArUco
+     * corners found by both and the time both detections took.
+     *
+     * @param pyramidLevels Pyramid levels to check, 0 to check the detection of the job configuration.
+     * @param tiles Tiles per side to check, 1 to check the detection of the job configuration.
+     */
+    void checkDetection(const cv::aruco::CharucoDetector& charucoDetector,
+                        std::vector<CamData>& camDatas,
+                        const Config::FileConfig& fileConfig,
+                        const std::filesystem::path& jobPath,
+                        int pyramidLevels,
+                        int tiles);
+
+    [[nodiscard]] std::filesystem::path remapTablePath(const std::filesystem::path& jobPath, int camId);
+
+    [[nodiscard]] std::filesystem::path stereoRemapTablePath(const std::filesystem::path& jobPath,
+                                                             int camLeftId,
+                                                             int camRightId,
+                                                             bool isLeft);
+
+    /**
+     * @brief Export fixed-point remap tables for every camera and for both sides of every stereo pair.
+     *
+     * The pairs are rectified with cv::stereoRectify and the resulting R/P/Q are stored with the pair. The tables are
+     * written in the memory mappable RemapTable format, so consumers can undistort without recomputing the maps.
+     */
+    void exportRemapTables(std::vector<CamData>& camDatas,
+                           std::vector<StereoCalibData>& stereoCalibDatas,
+                           const std::filesystem::path& jobPath);
+
+    /**
+     * @brief Undistort all verified images of every camera and rectify every stereo pair with the exported tables.
+     *
+     * Writes to images/undistorted/cam_<id> and images/rectified/pair_<left>_<right>, the rectified pairs are stored
+     * side by side with horizontal lines to check the rectification visually.
+     */
+    void undistortImages(std::vector<CamData>& camDatas,
+                         std::vector<StereoCalibData>& stereoCalibDatas,
+                         const std::filesystem::path& jobPath);
 }
 
 
-#endif //YACCP_SRC_CAMERA_CALIBRATION_HPP
\ No newline at end of file
+#endif //YACCP_SRC_CAMERA_CALIBRATION_HPP
@@ -20,6 +20,14 @@ namespace YACCP::CLI {
                        "Whether to generate an event video of the generated board")
             ->default_str("false");
 
+        subCmd
+            ->add_option("--blink-frequency",
+                         config.blinkFrequency,
+                         "Frequency in Hz at which the board blinks in the event video, set the same blink_frequency "
+                         "on the Prophesee worker to reconstruct it with the blink representation")
+            ->check(::CLI::Range(1., GlobalVariables::videoFps / 2.))
+            ->capture_default_str();
+
         return subCmd;
     }
 } // namespace YACCP::CLI
\ No newline at end of file
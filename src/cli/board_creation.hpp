@@ -1,6 +1,7 @@
 #ifndef YACCP_SRC_CLI_BOARD_CREATION_HPP
 #define YACCP_SRC_CLI_BOARD_CREATION_HPP
 #include "../global_variables/cli_defaults.hpp"
+#include "../global_variables/config_defaults.hpp"
 
 #include <CLI/App.hpp>
 
@@ -11,6 +12,7 @@ namespace YACCP::CLI {
         std::string jobId{};
         bool generateImage{GlobalVariables::generateImage};
         bool generateVideo{GlobalVariables::generateVideo};
+        double blinkFrequency{GlobalVariables::blinkFrequency};
     };
 
     ::CLI::App* addBoardCreationCmd(::CLI::App & app, BoardCreationCmdConfig & config);
@@ -12,7 +12,86 @@ namespace YACCP::CLI {
         calibrationCmds.calibration->require_option(1);
 
         calibrationCmds.mono = calibrationCmds.calibration->add_subcommand("mono", "Mono calibration");
+
+        calibrationCmds.mono
+            ->add_option("--outlier-rounds",
+                         config.outlierRounds,
+                         "Maximum amount of outlier rejection rounds, disabled by default, 3 is a good start")
+            ->check(::CLI::NonNegativeNumber)
+            ->capture_default_str();
+        calibrationCmds.mono
+            ->add_option("--outlier-threshold",
+                         config.outlierThreshold,
+                         "Reject corners this many robust standard deviations above the median reprojection error")
+            ->check(::CLI::PositiveNumber)
+            ->capture_default_str();
+        calibrationCmds.mono->add_flag("--warm-start",
+                                       config.warmStart,
+                                       "Seed the calibration with the most recent calibration of the same cameras");
+        calibrationCmds.mono->add_flag("--quick-check",
+                                       config.quickCheck,
+                                       "Only verify the most recent calibration of the same cameras and report drift");
+        calibrationCmds.mono->add_option("--previous-job-id",
+                                         config.previousJobId,
+                                         "Job ID to take the previous calibration from, defaults to the newest match");
+        calibrationCmds.mono
+            ->add_option("--solver",
+                         config.solver,
+                         "Solver for the intrinsics, the native solver assembles the normal equations multi-threaded")
+            ->check(::CLI::IsMember({"opencv", "native"}))
+            ->capture_default_str();
+        calibrationCmds.mono->add_flag("--benchmark",
+                                       config.benchmark,
+                                       "Run both solvers on the same detections and report timing and differences");
+
         calibrationCmds.stereo = calibrationCmds.calibration->add_subcommand("stereo", "stereo calibration");
+        calibrationCmds.stereo->add_flag("--spanning-tree",
+                                         config.spanningTree,
+                                         "Only calibrate the pairs of a maximum overlap spanning tree");
+        calibrationCmds.stereo
+            ->add_option("--loop-closures",
+                         config.loopClosures,
+                         "Amount of extra pairs to calibrate as a consistency check of the spanning tree")
+            ->check(::CLI::NonNegativeNumber)
+            ->needs("--spanning-tree");
+
+        // Shared by mono and stereo calibration.
+        for (auto* subCmd : {calibrationCmds.mono, calibrationCmds.stereo}) {
+            subCmd
+                ->add_option("--bootstrap",
+                             config.bootstrapRuns,
+                             "Amount of bootstrap resamples to estimate the uncertainty of the calibration with")
+                ->check(::CLI::NonNegativeNumber);
+        }
+
+        calibrationCmds.joint = calibrationCmds.calibration->add_subcommand(
+            "joint",
+            "Joint calibration of all cameras with a bundle adjustment, requires mono calibration");
+
+        calibrationCmds.joint->add_flag("--fix-intrinsics",
+                                        config.fixIntrinsics,
+                                        "Only refine the camera poses, keep the mono intrinsics fixed");
+
+        calibrationCmds.maps = calibrationCmds.calibration->add_subcommand(
+            "maps",
+            "Export fixed-point undistortion and rectification tables for every camera and stereo pair");
+        calibrationCmds.undistort = calibrationCmds.calibration->add_subcommand(
+            "undistort",
+            "Undistort and rectify all verified images with the exported tables");
+
+        calibrationCmds.checkDetection = calibrationCmds.calibration->add_subcommand(
+            "check-detection",
+            "Compare the corners of the pyramid or tiled detection with the full resolution detection on all verified "
+            "images, defaults to the detection the job was recorded with");
+        auto* pyramidLevels{
+            calibrationCmds.checkDetection
+            ->add_option("--pyramid-levels", config.pyramidLevels, "Pyramid levels to check")
+            ->check(::CLI::Range(1, GlobalVariables::maxPyramidLevels))
+        };
+        calibrationCmds.checkDetection
+            ->add_option("--tiles", config.tiles, "Tiles per side of the frame to check")
+            ->check(::CLI::Range(2, GlobalVariables::maxDetectionTiles))
+            ->excludes(pyramidLevels);
 
         return calibrationCmds;
     }
@@ -1,17 +1,37 @@
 #ifndef YACCP_SRC_CLI_CALIBRATION_HPP
 #define YACCP_SRC_CLI_CALIBRATION_HPP
+#include "../global_variables/cli_defaults.hpp"
+#include "../global_variables/config_defaults.hpp"
+
 #include <CLI/App.hpp>
 
 namespace YACCP::CLI {
     struct CalibrationCmdConfig {
         bool showAvailableJobs{};
         std::string jobId{};
+        bool fixIntrinsics{};
+        bool spanningTree{};
+        int loopClosures{GlobalVariables::loopClosures};
+        int outlierRounds{GlobalVariables::outlierRounds};
+        double outlierThreshold{GlobalVariables::outlierThreshold};
+        bool warmStart{};
+        bool quickCheck{};
+        std::string previousJobId{};
+        int bootstrapRuns{GlobalVariables::bootstrapRuns};
+        std::string solver{GlobalVariables::monoSolver};
+        bool benchmark{};
+        int pyramidLevels{};
+        int tiles{GlobalVariables::detectionTiles};
     };
 
     struct CalibrationCmds {
         ::CLI::App* calibration{};
         ::CLI::App* mono{};
         ::CLI::App* stereo{};
+        ::CLI::App* joint{};
+        ::CLI::App* maps{};
+        ::CLI::App* undistort{};
+        ::CLI::App* checkDetection{};
     };
 
     CalibrationCmds addCalibrationCmds(::CLI::App & app, CalibrationCmdConfig & config);
@@ -0,0 +1,32 @@
+#include "extraction.hpp"
+
+namespace YACCP::CLI {
+    ::CLI::App* addExtractionCmd(::CLI::App& app, ExtractionCmdConfig& config) {
+        ::CLI::App* subCmd = app.add_subcommand(
+            "extract",
+            "Regenerate event frames at the external triggers from the recorded event file");
+
+        subCmd->add_option("-j, --job-id", config.jobId, "Give a specific job ID to extract frames for")->required();
+        auto* frames{
+            subCmd->add_option("-f, --frames",
+                               config.frames,
+                               "Frame indices to regenerate, defaults to the frames already in the raw images")
+                  ->check(::CLI::PositiveNumber)
+        };
+        subCmd->add_flag("-a, --all", config.allTriggers, "Regenerate a frame at every trigger")->excludes(frames);
+        subCmd->add_option("--accumulation-time",
+                           config.accumulationTime,
+                           "Accumulation time in microseconds, defaults to the trigger frame window of the recording")
+              ->check(::CLI::PositiveNumber);
+        subCmd->add_option("--representation",
+                           config.representation,
+                           "Frame representation, defaults to the representation of the recording")
+              ->check(::CLI::IsMember({"metavision", "count", "polarity", "time_surface", "blink"}));
+        subCmd->add_option("--blink-frequency",
+                           config.blinkFrequency,
+                           "Blink frequency of the board video in Hz, defaults to the blink frequency of the recording")
+              ->check(::CLI::PositiveNumber);
+
+        return subCmd;
+    }
+} // namespace YACCP::CLI
@@ -0,0 +1,18 @@
+#ifndef YACCP_SRC_CLI_EXTRACTION_HPP
+#define YACCP_SRC_CLI_EXTRACTION_HPP
+#include <CLI/App.hpp>
+
+namespace YACCP::CLI {
+    struct ExtractionCmdConfig {
+        std::string jobId{};
+        std::vector<int> frames{};
+        bool allTriggers{};
+        int accumulationTime{};
+        std::string representation{};
+        double blinkFrequency{};
+    };
+
+    ::CLI::App* addExtractionCmd(::CLI::App & app, ExtractionCmdConfig & config);
+} // namespace YACCP::CLI
+
+#endif // YACCP_SRC_CLI_EXTRACTION_HPP
@@ -30,5 +30,8 @@ namespace YACCP::CLI {
 
         // Camera calibration CLI options
         cliCmds.calibrationCmds = addCalibrationCmds(cliCmds.app, cliCmdConfig.calibrationCmdConfig);
+
+        // Event frame extraction CLI options
+        cliCmds.extractionCmd = addExtractionCmd(cliCmds.app, cliCmdConfig.extractionCmdConfig);
     }
 } // YACCP::CLI
\ No newline at end of file
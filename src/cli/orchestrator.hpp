@@ -2,6 +2,7 @@
 #define YACCP_SRC_CLI_ORCHESTRATOR_HPP
 #include "board_creation.hpp"
 #include "calibration.hpp"
+#include "extraction.hpp"
 #include "recording.hpp"
 #include "validation.hpp"
 
@@ -17,6 +18,7 @@ namespace YACCP::CLI {
         RecordingCmdConfig recordingCmdConfig{};
         ValidationCmdConfig validationCmdConfig{};
         CalibrationCmdConfig calibrationCmdConfig{};
+        ExtractionCmdConfig extractionCmdConfig{};
     };
 
     struct CliCmds {
@@ -25,6 +27,7 @@ namespace YACCP::CLI {
         ::CLI::App* recordingCmd{};
         ::CLI::App* validationCmd{};
         CalibrationCmds calibrationCmds{};
+        ::CLI::App* extractionCmd{};
     };
 
     void addCli(CliCmdConfig& cliCmdConfig, CliCmds& cliCmds);
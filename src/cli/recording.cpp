@@ -8,6 +8,9 @@ namespace YACCP::CLI {
         subCmd->add_option("-j, --job-id", config.jobId, "Give a specific job ID to record to")->default_str(
             "Latest job ID");
         subCmd->add_flag("-c, --show-cams", config.showAvailableCams, "Show all available cameras");
+        subCmd->add_option("--undistort-with",
+                           config.undistortJobId,
+                           "Undistort the live view with the remap tables of a previously calibrated job ID");
 
         subCmd->parse_complete_callback([&config] {
             if (config.showAvailableJobs && config.showAvailableCams) {
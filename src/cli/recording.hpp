@@ -7,6 +7,7 @@ namespace YACCP::CLI {
         bool showAvailableJobs{};
         std::string jobId{};
         bool showAvailableCams{};
+        std::string undistortJobId{};
     };
 
     ::CLI::App* addRecordingCmd(::CLI::App & app, RecordingCmdConfig & config);
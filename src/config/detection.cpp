@@ -10,6 +10,19 @@ namespace YACCP::Config {
 
         config.openCvArucoDictionaryId = (*detectionTbl)["opencv_aruco_dictionary"].value_or(GlobalVariables::charucoDictionary);
         config.cornerMin = (*detectionTbl)["minimum_corner_fraction"].value_or(GlobalVariables::minCornerFraction);
+        config.pyramidLevels = (*detectionTbl)["pyramid_levels"].value_or(GlobalVariables::pyramidLevels);
+        if (config.pyramidLevels < 0 || config.pyramidLevels > GlobalVariables::maxPyramidLevels)
+            throw std::runtime_error("pyramid_levels must be between 0 and " +
+                                     std::to_string(GlobalVariables::maxPyramidLevels));
+        config.tiles = (*detectionTbl)["tiles"].value_or(GlobalVariables::detectionTiles);
+        if (config.tiles < 1 || config.tiles > GlobalVariables::maxDetectionTiles)
+            throw std::runtime_error("tiles must be between 1 and " +
+                                     std::to_string(GlobalVariables::maxDetectionTiles));
+        config.tileOverlap = (*detectionTbl)["tile_overlap"].value_or(GlobalVariables::tileOverlap);
+        if (config.tileOverlap <= 0. || config.tileOverlap >= .5)
+            throw std::runtime_error("tile_overlap must be between 0 and 0.5");
+        if (config.pyramidLevels > 0 && config.tiles > 1)
+            throw std::runtime_error("pyramid_levels and tiles can not be combined, pick one of both");
 
         // Load custom charuco parameters if set, otherwise load defaults.
         if (const auto* charuco{(*detectionTbl)["charuco_parameters"].as_table()}) {
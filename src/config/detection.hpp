@@ -1,5 +1,7 @@
 #ifndef YACCP_SRC_CONFIG_DETECTION_HPP
 #define YACCP_SRC_CONFIG_DETECTION_HPP
+#include "../global_variables/config_defaults.hpp"
+
 #include <nlohmann/json.hpp>
 
 #include <opencv2/objdetect/charuco_detector.hpp>
@@ -99,6 +101,12 @@ namespace YACCP::Config {
     struct DetectionConfig {
         int openCvArucoDictionaryId{};
         float cornerMin{};
+        // Amount of times the image is halved before the markers are detected, 0 detects at full resolution.
+        int pyramidLevels{};
+        // Tiles per side of the frame the markers are detected in parallel in, 1 detects in a single pass.
+        int tiles{};
+        // Overlap between neighbouring tiles as a fraction of the larger side of the frame.
+        double tileOverlap{};
 
         cv::aruco::CharucoParameters charucoParameters{};
         cv::aruco::DetectorParameters detectorParameters{};
@@ -109,6 +117,9 @@ namespace YACCP::Config {
         j = {
             {"openCvDictionaryId", d.openCvArucoDictionaryId},
             {"cornerMin", d.cornerMin},
+            {"pyramidLevels", d.pyramidLevels},
+            {"tiles", d.tiles},
+            {"tileOverlap", d.tileOverlap},
             {"charucoParameters", d.charucoParameters},
             {"detectorParameters", d.detectorParameters},
         };
@@ -118,6 +129,9 @@ namespace YACCP::Config {
     inline void from_json(const nlohmann::json& j, DetectionConfig& d) {
         (void)j.at("openCvDictionaryId").get_to(d.openCvArucoDictionaryId);
         (void)j.at("cornerMin").get_to(d.cornerMin);
+        d.pyramidLevels = j.value("pyramidLevels", GlobalVariables::pyramidLevels);
+        d.tiles = j.value("tiles", GlobalVariables::detectionTiles);
+        d.tileOverlap = j.value("tileOverlap", GlobalVariables::tileOverlap);
         (void)j.at("charucoParameters").get_to(d.charucoParameters);
         (void)j.at("detectorParameters").get_to(d.detectorParameters);
     }
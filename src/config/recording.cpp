@@ -47,6 +47,44 @@ namespace YACCP::Config {
     }
 
 
+    FrameRepresentation stringToFrameRepresentation(std::string representation) {
+        boost::algorithm::to_lower(representation);
+        if (const auto it{frameRepresentationsMap.find(representation)}; it != frameRepresentationsMap.end()) {
+            return it->second;
+        }
+        throw std::runtime_error("Unknown frame representation: " + representation);
+    }
+
+
+    std::string frameRepresentationToString(const FrameRepresentation representation) {
+        for (const auto& [key, value] : frameRepresentationsMap) {
+            if (value == representation) {
+                return key;
+            }
+        }
+        return "Not found";
+    }
+
+
+    FrameSlicing stringToFrameSlicing(std::string slicing) {
+        boost::algorithm::to_lower(slicing);
+        if (const auto it{frameSlicingsMap.find(slicing)}; it != frameSlicingsMap.end()) {
+            return it->second;
+        }
+        throw std::runtime_error("Unknown frame slicing: " + slicing);
+    }
+
+
+    std::string frameSlicingToString(const FrameSlicing slicing) {
+        for (const auto& [key, value] : frameSlicingsMap) {
+            if (value == slicing) {
+                return key;
+            }
+        }
+        return "Not found";
+    }
+
+
     bool compareByIndex(const RecordingConfig::Worker& a, const RecordingConfig::Worker& b) {
         return a.placement < b.placement;
     }
@@ -68,6 +106,37 @@ namespace YACCP::Config {
         config.detectionInterval = (*recordingTbl)["detection_interval"].value_or(GlobalVariables::detectionInterval);
         config.masterWorker = requireVariable<int>(*recordingTbl, "master_worker", "recording");
 
+        config.estimateCalibration = (*recordingTbl)["estimate_calibration"].value_or(
+            GlobalVariables::estimateCalibration);
+        config.estimateInterval = (*recordingTbl)["estimate_interval"].value_or(GlobalVariables::estimateInterval);
+        if (config.estimateInterval < 1) throw std::runtime_error("estimate_interval must be greater than zero");
+        config.autoStop = (*recordingTbl)["auto_stop"].value_or(GlobalVariables::autoStop);
+        config.autoStopThreshold = (*recordingTbl)["auto_stop_threshold"].value_or(GlobalVariables::autoStopThreshold);
+
+        config.motionGate = (*recordingTbl)["motion_gate"].value_or(GlobalVariables::motionGate);
+        config.gateEventRate = recordingTbl->contains("gate_event_rate")
+                                   ? std::optional{(*recordingTbl)["gate_event_rate"].value_or(0.)}
+                                   : std::nullopt;
+        config.gateFrameDifference = recordingTbl->contains("gate_frame_difference")
+                                         ? std::optional{(*recordingTbl)["gate_frame_difference"].value_or(0.)}
+                                         : std::nullopt;
+        config.gateTimeout = (*recordingTbl)["gate_timeout"].value_or(GlobalVariables::gateTimeout);
+        if (config.motionGate && !config.gateEventRate && !config.gateFrameDifference)
+            throw std::runtime_error("motion_gate needs gate_event_rate and/or gate_frame_difference");
+        if (config.gateTimeout < 0) throw std::runtime_error("gate_timeout can not be negative");
+
+        config.noveltyCapture = (*recordingTbl)["novelty_capture"].value_or(GlobalVariables::noveltyCapture);
+        config.noveltyCoverage = (*recordingTbl)["novelty_coverage"].value_or(GlobalVariables::noveltyCoverage);
+        config.noveltyDisplacement = (*recordingTbl)["novelty_displacement"].value_or(
+            GlobalVariables::noveltyDisplacement);
+        config.noveltyMinSpacing = (*recordingTbl)["novelty_min_spacing"].value_or(GlobalVariables::noveltyMinSpacing);
+        if (config.noveltyMinSpacing < 0) throw std::runtime_error("novelty_min_spacing can not be negative");
+
+        config.burstSize = (*recordingTbl)["burst_size"].value_or(GlobalVariables::burstSize);
+        if (config.burstSize < 1) throw std::runtime_error("burst_size must be greater than zero");
+        if (config.burstSize >= config.fps * config.detectionInterval)
+            throw std::runtime_error("burst_size must be smaller than fps * detection_interval");
+
         // Check whether the defined masterWorker variables is a natural number N
         // and does not exceed the number of workers
         if (config.masterWorker + 1 > workerArray->size() || config.masterWorker < 0)
@@ -120,6 +189,25 @@ namespace YACCP::Config {
                 prophesee.fallingEdgePolarity = requireVariable<int>(*workerTbl,
                                                                      "falling_edge_polarity",
                                                                      "[recording.workers]");
+                prophesee.frameRepresentation = stringToFrameRepresentation(
+                    (*workerTbl)["frame_representation"].value_or(std::string{GlobalVariables::frameRepresentation}));
+                prophesee.timeSurfaceDecay = (*workerTbl)["time_surface_decay"].value_or(
+                    GlobalVariables::timeSurfaceDecay);
+                if (prophesee.timeSurfaceDecay < 1)
+                    throw std::runtime_error("time_surface_decay must be greater than zero");
+                prophesee.blinkFrequency = (*workerTbl)["blink_frequency"].value_or(GlobalVariables::blinkFrequency);
+                if (prophesee.blinkFrequency <= 0)
+                    throw std::runtime_error("blink_frequency must be greater than zero");
+                prophesee.frameSlicing = stringToFrameSlicing(
+                    (*workerTbl)["frame_slicing"].value_or(std::string{GlobalVariables::frameSlicing}));
+                prophesee.sliceEventCount = (*workerTbl)["slice_event_count"].value_or(
+                    GlobalVariables::sliceEventCount);
+                if (prophesee.sliceEventCount < 1)
+                    throw std::runtime_error("slice_event_count must be greater than zero");
+                prophesee.sliceCandidates = (*workerTbl)["slice_candidates"].value_or(
+                    GlobalVariables::sliceCandidates);
+                if (prophesee.sliceCandidates < 2)
+                    throw std::runtime_error("slice_candidates must be at least two");
 
                 // Biases
                 prophesee.biasDiff = workerTbl->contains("bias_diff")
@@ -162,6 +250,40 @@ namespace YACCP::Config {
 
                 }
 
+                // Software event filter chain
+                prophesee.polarityFilter = (*workerTbl)["polarity_filter"].value_or(GlobalVariables::polarityFilter);
+                if (prophesee.polarityFilter < -1 || prophesee.polarityFilter > 1)
+                    throw std::runtime_error("polarity_filter must be 1 (ON), 0 (OFF) or -1 (both)");
+                if (const auto* hotPixels{(*workerTbl)["hot_pixels"].as_array()}) {
+                    for (const toml::node& node : *hotPixels) {
+                        const auto* pixel{node.as_array()};
+                        if (!pixel || pixel->size() != 2)
+                            throw std::runtime_error("Every hot_pixels entry must be an [x, y] array");
+                        prophesee.hotPixels.push_back({(*pixel)[0].value_or(-1), (*pixel)[1].value_or(-1)});
+                    }
+                }
+                if (const auto* roi{(*workerTbl)["roi"].as_array()}) {
+                    if (roi->size() != 4) throw std::runtime_error("roi must be an [x, y, width, height] array");
+                    prophesee.roi = {
+                        (*roi)[0].value_or(0), (*roi)[1].value_or(0), (*roi)[2].value_or(0), (*roi)[3].value_or(0)
+                    };
+                    if ((*prophesee.roi)[2] < 1 || (*prophesee.roi)[3] < 1)
+                        throw std::runtime_error("roi width and height must be greater than zero");
+                }
+                prophesee.activityThreshold = (*workerTbl)["activity_threshold"].value_or(
+                    GlobalVariables::activityThreshold);
+                if (prophesee.activityThreshold < 0)
+                    throw std::runtime_error("activity_threshold must be non-negative");
+
+                // Event rate governor
+                prophesee.governorEnabled = (*workerTbl)["enable_governor"].value_or(GlobalVariables::governorEnabled);
+                if (prophesee.governorEnabled) {
+                    prophesee.governorMaxLag = (*workerTbl)["governor_max_lag"].value_or(
+                        GlobalVariables::governorMaxLag);
+                    if (prophesee.governorMaxLag < 1)
+                        throw std::runtime_error("governor_max_lag must be greater than zero");
+                }
+
                 worker.configBackend = prophesee;
                 break;
             }
@@ -1,5 +1,8 @@
 #ifndef YACCP_SRC_CONFIG_RECORDING_HPP
 #define YACCP_SRC_CONFIG_RECORDING_HPP
+#include "../global_variables/config_defaults.hpp"
+
+#include <array>
 #include <variant>
 #include <metavision/hal/facilities/i_event_trail_filter_module.h>
 
@@ -17,8 +20,43 @@ namespace YACCP::Config {
         basler,
     };
 
+    /**
+     * @brief How the events of a trigger window are turned into a frame.
+     *
+     * Metavision uses OnDemandFrameGenerationAlgorithm, the others are the own accumulation kernels: event counts,
+     * signed polarity balance, an exponentially decayed time surface and the blink-synchronous reconstruction of the
+     * board video.
+     */
+    enum class FrameRepresentation {
+        metavision,
+        count,
+        polarity,
+        timeSurface,
+        blink,
+    };
+
+    /**
+     * @brief How the event window of a trigger frame is chosen.
+     *
+     * Fixed uses the window of the frame rate, eventCount a window holding a target amount of events and best keeps
+     * the candidate window whose frame has the most detected corners, or the highest sharpness without a detection.
+     */
+    enum class FrameSlicing {
+        fixed,
+        eventCount,
+        best,
+    };
+
     Metavision::I_EventTrailFilterModule::Type stringToEftMode(std::string mode);
 
+    FrameRepresentation stringToFrameRepresentation(std::string representation);
+
+    std::string frameRepresentationToString(FrameRepresentation representation);
+
+    FrameSlicing stringToFrameSlicing(std::string slicing);
+
+    std::string frameSlicingToString(FrameSlicing slicing);
+
     std::string etfModeToString(Metavision::I_EventTrailFilterModule::Type eftMode);
 
 
@@ -33,6 +71,20 @@ namespace YACCP::Config {
         {"trail", Metavision::I_EventTrailFilterModule::Type::TRAIL}
     };
 
+    inline std::unordered_map<std::string, FrameRepresentation> frameRepresentationsMap{
+        {"metavision", FrameRepresentation::metavision},
+        {"count", FrameRepresentation::count},
+        {"polarity", FrameRepresentation::polarity},
+        {"time_surface", FrameRepresentation::timeSurface},
+        {"blink", FrameRepresentation::blink}
+    };
+
+    inline std::unordered_map<std::string, FrameSlicing> frameSlicingsMap{
+        {"fixed", FrameSlicing::fixed},
+        {"event_count", FrameSlicing::eventCount},
+        {"best", FrameSlicing::best}
+    };
+
     struct Basler {
     };
 
@@ -40,6 +92,12 @@ namespace YACCP::Config {
         int accumulationTime{};
         bool saveEventFile{};
         int fallingEdgePolarity{};
+        FrameRepresentation frameRepresentation{};
+        int timeSurfaceDecay{}; // microseconds
+        double blinkFrequency{}; // Hz
+        FrameSlicing frameSlicing{};
+        int sliceEventCount{};
+        int sliceCandidates{};
 
         // https://docs.prophesee.ai/stable/hw/manuals/biases.html
         std::optional<int> biasDiff{};
@@ -57,6 +115,16 @@ namespace YACCP::Config {
         bool etfEnabled{};
         std::optional<Metavision::I_EventTrailFilterModule::Type> etfMode{};
         std::optional<int> etfThreshold{};
+
+        // Software event filter chain, applied to the live events and the offline extraction, not to the event file.
+        int polarityFilter{}; // 1 keeps ON, 0 keeps OFF and -1 keeps both polarities
+        std::vector<std::array<int, 2> > hotPixels{};
+        std::optional<std::array<int, 4> > roi{}; // x, y, width, height
+        int activityThreshold{}; // microseconds, 0 disables the activity filter
+
+        // Adaptive event rate governor, adjusts the ERC when enabled and otherwise decimates the preview.
+        bool governorEnabled{};
+        int governorMaxLag{}; // milliseconds
     };
 
     using ConfigBackend = std::variant<Basler, Prophesee>;
@@ -72,6 +140,28 @@ namespace YACCP::Config {
         int fps{};
         int detectionInterval{};
         int masterWorker{};
+
+        // Online calibration estimate, these are user variables and are not stored in the job data.
+        bool estimateCalibration{};
+        int estimateInterval{};
+        bool autoStop{};
+        double autoStopThreshold{};
+
+        // Motion gate of the master camera, these are user variables and are not stored in the job data.
+        bool motionGate{};
+        std::optional<double> gateEventRate{}; // events per second
+        std::optional<double> gateFrameDifference{}; // mean absolute grey level difference
+        int gateTimeout{}; // milliseconds
+
+        // Novelty driven capture of the master camera, these are user variables and are not stored in the job data.
+        bool noveltyCapture{};
+        double noveltyCoverage{}; // Fraction of the corners in uncovered cells
+        double noveltyDisplacement{}; // Mean corner displacement relative to the image diagonal
+        int noveltyMinSpacing{}; // milliseconds
+
+        // Consecutive synchronised frames per request, only the best set is validated. Not stored in the job data.
+        int burstSize{};
+
         std::vector<Worker> workers{};
     };
 
@@ -81,6 +171,12 @@ namespace YACCP::Config {
             {"accumulationTime", p.accumulationTime},
             {"fallingEdgePolarity", p.fallingEdgePolarity},
             {"saveEventFile", p.saveEventFile},
+            {"frameRepresentation", frameRepresentationToString(p.frameRepresentation)},
+            {"timeSurfaceDecay", p.timeSurfaceDecay},
+            {"blinkFrequency", p.blinkFrequency},
+            {"frameSlicing", frameSlicingToString(p.frameSlicing)},
+            {"sliceEventCount", p.sliceEventCount},
+            {"sliceCandidates", p.sliceCandidates},
 
             {"biasDiff", p.biasDiff},
             {"biasDiffOn", p.biasDiffOn},
@@ -100,6 +196,16 @@ namespace YACCP::Config {
             j["etfMode"] = etfModeToString(*p.etfMode);
             j["etfThreshold"] = p.etfThreshold;
         }
+
+        j["polarityFilter"] = p.polarityFilter;
+        if (!p.hotPixels.empty()) j["hotPixels"] = p.hotPixels;
+        if (p.roi) j["roi"] = *p.roi;
+        j["activityThreshold"] = p.activityThreshold;
+
+        j["governorEnabled"] = p.governorEnabled;
+        if (p.governorEnabled) {
+            j["governorMaxLag"] = p.governorMaxLag;
+        }
     }
 
 
@@ -107,6 +213,13 @@ namespace YACCP::Config {
         (void)j.at("accumulationTime").get_to(p.accumulationTime);
         (void)j.at("fallingEdgePolarity").get_to(p.fallingEdgePolarity);
         (void)j.at("saveEventFile").get_to(p.saveEventFile);
+        // Jobs recorded before the own accumulation kernels existed always used the Metavision representation.
+        p.frameRepresentation = stringToFrameRepresentation(j.value("frameRepresentation", "metavision"));
+        p.timeSurfaceDecay = j.value("timeSurfaceDecay", GlobalVariables::timeSurfaceDecay);
+        p.blinkFrequency = j.value("blinkFrequency", GlobalVariables::blinkFrequency);
+        p.frameSlicing = stringToFrameSlicing(j.value("frameSlicing", GlobalVariables::frameSlicing));
+        p.sliceEventCount = j.value("sliceEventCount", GlobalVariables::sliceEventCount);
+        p.sliceCandidates = j.value("sliceCandidates", GlobalVariables::sliceCandidates);
 
         (void)j.at("biasDiff").get_to(p.biasDiff);
         (void)j.at("biasDiffOn").get_to(p.biasDiffOn);
@@ -125,6 +238,18 @@ namespace YACCP::Config {
             p.etfMode = stringToEftMode(j.at("etfMode").get<std::string>());
             (void)j.at("etfThreshold").get_to(p.etfThreshold);
         }
+
+        // Jobs recorded before the filter chain existed only kept the ON events.
+        p.polarityFilter = j.value("polarityFilter", 1);
+        if (j.contains("hotPixels")) (void)j.at("hotPixels").get_to(p.hotPixels);
+        if (j.contains("roi")) p.roi = j.at("roi").get<std::array<int, 4> >();
+        p.activityThreshold = j.value("activityThreshold", 0);
+
+        // Jobs recorded before the governor existed did not store it.
+        p.governorEnabled = j.value("governorEnabled", false);
+        if (p.governorEnabled) {
+            (void)j.at("governorMaxLag").get_to(p.governorMaxLag);
+        }
     }
 
 
@@ -0,0 +1,16 @@
+#include "board_detection.hpp"
+
+#include "pyramid_detection.hpp"
+#include "tiled_detection.hpp"
+
+#include "../utility.hpp"
+
+namespace YACCP {
+    Utility::CharucoResults findBoardConfigured(const cv::aruco::CharucoDetector& charucoDetector,
+                                                const cv::Mat& gray,
+                                                const int cornerMin,
+                                                const Config::DetectionConfig& config) {
+        if (config.tiles > 1) return findBoardTiled(charucoDetector, gray, cornerMin, config.tiles, config.tileOverlap);
+        return findBoardPyramid(charucoDetector, gray, cornerMin, config.pyramidLevels);
+    }
+} // YACCP
@@ -0,0 +1,22 @@
+#ifndef YACCP_SRC_DETECTION_BOARD_DETECTION_HPP
+#define YACCP_SRC_DETECTION_BOARD_DETECTION_HPP
+#include "../config/detection.hpp"
+
+namespace YACCP::Utility {
+    struct CharucoResults;
+}
+
+namespace YACCP {
+    /**
+     * @brief Detect the board with the detection mode of the configuration, see Utility::findBoard.
+     *
+     * Tiled detection when more than one tile is configured, pyramid detection when pyramid levels are configured and
+     * a single full resolution pass otherwise.
+     */
+    [[nodiscard]] Utility::CharucoResults findBoardConfigured(const cv::aruco::CharucoDetector& charucoDetector,
+                                                              const cv::Mat& gray,
+                                                              int cornerMin,
+                                                              const Config::DetectionConfig& config);
+} // YACCP
+
+#endif //YACCP_SRC_DETECTION_BOARD_DETECTION_HPP
@@ -0,0 +1,77 @@
+#include "pyramid_detection.hpp"
+
+#include "../utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    Utility::CharucoResults findBoardPyramid(const cv::aruco::CharucoDetector& charucoDetector,
+                                             const cv::Mat& gray,
+                                             const int cornerMin,
+                                             const int levels) {
+        if (levels == 0) return Utility::findBoard(charucoDetector, gray, cornerMin);
+
+        std::vector<cv::Mat> pyramid;
+        cv::buildPyramid(gray, pyramid, levels);
+
+        Utility::CharucoResults charucoResults;
+        const cv::aruco::ArucoDetector arucoDetector{
+            charucoDetector.getBoard().getDictionary(),
+            charucoDetector.getDetectorParameters(),
+            charucoDetector.getRefineParameters()
+        };
+        arucoDetector.detectMarkers(pyramid.back(), charucoResults.markerCorners, charucoResults.markerIds);
+        if (charucoResults.markerIds.empty()) return charucoResults;
+
+        refinePyramidMarkers(gray, charucoResults.markerCorners, levels, charucoDetector.getDetectorParameters());
+
+        // Given markers the detector skips its own marker detection and only interpolates the ChArUco corners.
+        charucoDetector.detectBoard(gray,
+                                    charucoResults.charucoCorners,
+                                    charucoResults.charucoIds,
+                                    charucoResults.markerCorners,
+                                    charucoResults.markerIds);
+
+        if (charucoResults.charucoCorners.size() > cornerMin) {
+            charucoResults.boardFound = true;
+        }
+        return charucoResults;
+    }
+
+
+    void refinePyramidMarkers(const cv::Mat& gray,
+                              std::vector<std::vector<cv::Point2f> >& markerCorners,
+                              const int levels,
+                              const cv::aruco::DetectorParameters& parameters) {
+        if (markerCorners.empty()) return;
+
+        // pyrDown samples between the pixel centres, x maps back to (x + .5) * scale - .5.
+        const auto scale{static_cast<float>(1 << levels)};
+        const cv::Point2f offset{(scale - 1.F) / 2.F, (scale - 1.F) / 2.F};
+        std::vector<cv::Point2f> corners;
+        double minPerimeter{std::numeric_limits<double>::max()};
+        for (auto& marker : markerCorners) {
+            for (auto& corner : marker) corner = corner * scale + offset;
+            minPerimeter = std::min(minPerimeter, cv::arcLength(marker, true));
+            corners.insert(corners.end(), marker.begin(), marker.end());
+        }
+
+        // The decimated corners are off by up to a pixel of the top level, the window stays well inside the marker.
+        const int window{std::max(2, std::min(static_cast<int>(scale) + 1, static_cast<int>(minPerimeter / 16.)))};
+        cv::cornerSubPix(gray,
+                         corners,
+                         {window, window},
+                         {-1, -1},
+                         cv::TermCriteria(cv::TermCriteria::MAX_ITER | cv::TermCriteria::EPS,
+                                          parameters.cornerRefinementMaxIterations,
+                                          parameters.cornerRefinementMinAccuracy));
+        auto refined{corners.begin()};
+        for (auto& marker : markerCorners) {
+            for (auto& corner : marker) corner = *refined++;
+        }
+    }
+} // YACCP
@@ -0,0 +1,37 @@
+#ifndef YACCP_SRC_DETECTION_PYRAMID_DETECTION_HPP
+#define YACCP_SRC_DETECTION_PYRAMID_DETECTION_HPP
+#include <opencv2/objdetect/charuco_detector.hpp>
+
+namespace YACCP::Utility {
+    struct CharucoResults;
+}
+
+namespace YACCP {
+    /**
+     * @brief Detect the board coarse to fine, see Utility::findBoard.
+     *
+     * The markers are detected on the image halved the given amount of times, which costs a fraction of a full
+     * resolution detection. Their corners are mapped back and refined with sub-pixel refinement on the full resolution
+     * image in windows of about one decimated pixel. The ChArUco corners are then interpolated and refined on the full
+     * resolution image from these markers.
+     *
+     * @param levels Amount of pyramid levels, 0 detects at full resolution.
+     */
+    [[nodiscard]] Utility::CharucoResults findBoardPyramid(const cv::aruco::CharucoDetector& charucoDetector,
+                                                           const cv::Mat& gray,
+                                                           int cornerMin,
+                                                           int levels);
+
+    /**
+     * @brief Map marker corners detected on a pyramid level back to the full resolution image and refine them there.
+     *
+     * @param markerCorners Corners on the pyramid level, replaced by the refined full resolution corners.
+     * @param parameters Parameters of the detector, the sub-pixel termination criteria are taken from them.
+     */
+    void refinePyramidMarkers(const cv::Mat& gray,
+                              std::vector<std::vector<cv::Point2f> >& markerCorners,
+                              int levels,
+                              const cv::aruco::DetectorParameters& parameters);
+} // YACCP
+
+#endif //YACCP_SRC_DETECTION_PYRAMID_DETECTION_HPP
@@ -0,0 +1,164 @@
+#include "tiled_detection.hpp"
+
+#include "pyramid_detection.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+#include "../utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    namespace {
+        /**
+         * @brief Markers of a single tile in tile coordinates, an empty tile is the decimated full frame.
+         */
+        struct TileDetection {
+            cv::Rect tile;
+            std::vector<std::vector<cv::Point2f> > markerCorners;
+            std::vector<int> markerIds;
+        };
+
+
+        // Distance of a marker to the nearest edge where its tile cuts the frame.
+        float seamDistance(const std::vector<cv::Point2f>& marker, const cv::Rect& tile, const cv::Size frameSize) {
+            float distance{std::numeric_limits<float>::max()};
+            for (const auto& corner : marker) {
+                if (tile.x > 0) distance = std::min(distance, corner.x);
+                if (tile.y > 0) distance = std::min(distance, corner.y);
+                if (tile.x + tile.width < frameSize.width)
+                    distance = std::min(distance, static_cast<float>(tile.width) - corner.x);
+                if (tile.y + tile.height < frameSize.height)
+                    distance = std::min(distance, static_cast<float>(tile.height) - corner.y);
+            }
+            return distance;
+        }
+    }
+
+
+    Utility::CharucoResults findBoardTiled(const cv::aruco::CharucoDetector& charucoDetector,
+                                           const cv::Mat& gray,
+                                           const int cornerMin,
+                                           const int tiles,
+                                           const double overlap) {
+        if (tiles <= 1) return Utility::findBoard(charucoDetector, gray, cornerMin);
+
+        const double frameSize{static_cast<double>(std::max(gray.cols, gray.rows))};
+        const auto overlapPixels{static_cast<int>(std::lround(overlap * frameSize))};
+        const auto& detectorParameters{charucoDetector.getDetectorParameters()};
+
+        // A marker with a perimeter of at least the overlap may not fit in any tile. It is searched on the frame
+        // decimated until such a marker is just above the smallest size that is still reliably decoded. Without a
+        // level to decimate, that search would be a full resolution pass by itself.
+        if (overlapPixels < 2 * GlobalVariables::tileCoarseMinPerimeter) {
+            static std::once_flag warned;
+            std::call_once(warned,
+                           [&] {
+                               std::cerr << "Tile overlap of " << overlapPixels << " px is too small to search large "
+                                   "markers on a decimated frame, detecting in a single pass instead\n";
+                           });
+            return Utility::findBoard(charucoDetector, gray, cornerMin);
+        }
+        const int levels{
+            static_cast<int>(std::floor(std::log2(static_cast<double>(overlapPixels) /
+                                                  GlobalVariables::tileCoarseMinPerimeter)))
+        };
+
+        std::vector<TileDetection> detections;
+        for (auto row{0}; row < tiles; ++row) {
+            for (auto column{0}; column < tiles; ++column) {
+                const int left{gray.cols * column / tiles - overlapPixels / 2};
+                const int top{gray.rows * row / tiles - overlapPixels / 2};
+                const int right{gray.cols * (column + 1) / tiles + overlapPixels / 2};
+                const int bottom{gray.rows * (row + 1) / tiles + overlapPixels / 2};
+                detections.push_back({cv::Rect(left, top, right - left, bottom - top) & cv::Rect({}, gray.size())});
+            }
+        }
+        detections.emplace_back();
+
+        cv::parallel_for_(cv::Range(0, static_cast<int>(detections.size())),
+                          [&](const cv::Range& range) {
+                              for (auto i{range.start}; i < range.end; ++i) {
+                                  auto& [tile, markerCorners, markerIds]{detections[i]};
+                                  cv::aruco::DetectorParameters parameters{detectorParameters};
+                                  cv::Mat image;
+
+                                  if (!tile.empty()) {
+                                      // The perimeter rates are relative to the searched image, kept in pixels.
+                                      const double scale{frameSize / std::max(tile.width, tile.height)};
+                                      parameters.minMarkerPerimeterRate *= scale;
+                                      parameters.maxMarkerPerimeterRate *= scale;
+                                      parameters.minMarkerLengthRatioOriginalImg = static_cast<float>(
+                                          std::min(1., parameters.minMarkerLengthRatioOriginalImg * scale));
+                                      image = gray(tile);
+                                  } else {
+                                      std::vector<cv::Mat> pyramid;
+                                      cv::buildPyramid(gray, pyramid, levels);
+                                      image = pyramid.back();
+
+                                      const double coarseRate{overlapPixels / frameSize};
+                                      parameters.minMarkerPerimeterRate =
+                                          std::max(parameters.minMarkerPerimeterRate, coarseRate);
+                                      parameters.minMarkerLengthRatioOriginalImg =
+                                          std::max(parameters.minMarkerLengthRatioOriginalImg,
+                                                   static_cast<float>(coarseRate / 4.));
+                                  }
+
+                                  const cv::aruco::ArucoDetector arucoDetector{
+                                      charucoDetector.getBoard().getDictionary(),
+                                      parameters,
+                                      charucoDetector.getRefineParameters()
+                                  };
+                                  arucoDetector.detectMarkers(image, markerCorners, markerIds);
+                              }
+                          });
+
+        // Every marker ID occurs once on the board, duplicates come from the overlaps and the decimated frame.
+        std::map<int, std::pair<float, std::vector<cv::Point2f> > > markers;
+        for (auto& [tile, markerCorners, markerIds] : detections) {
+            if (tile.empty()) continue;
+
+            const cv::Point2f offset{tile.tl()};
+            for (std::size_t i{0}; i < markerIds.size(); ++i) {
+                const float distance{seamDistance(markerCorners[i], tile, gray.size())};
+                for (auto& corner : markerCorners[i]) corner += offset;
+
+                const auto [it, inserted]{markers.try_emplace(markerIds[i], distance, markerCorners[i])};
+                if (!inserted && distance > it->second.first) it->second = {distance, std::move(markerCorners[i])};
+            }
+        }
+
+        auto& [coarseTile, coarseCorners, coarseIds]{detections.back()};
+        refinePyramidMarkers(gray, coarseCorners, levels, detectorParameters);
+        for (std::size_t i{0}; i < coarseIds.size(); ++i) {
+            (void)markers.try_emplace(coarseIds[i], -1.F, std::move(coarseCorners[i]));
+        }
+
+        Utility::CharucoResults charucoResults;
+        if (markers.empty()) return charucoResults;
+
+        for (auto& [id, marker] : markers) {
+            charucoResults.markerIds.emplace_back(id);
+            charucoResults.markerCorners.emplace_back(std::move(marker.second));
+        }
+
+        // Given markers the detector skips its own marker detection and only interpolates the ChArUco corners.
+        charucoDetector.detectBoard(gray,
+                                    charucoResults.charucoCorners,
+                                    charucoResults.charucoIds,
+                                    charucoResults.markerCorners,
+                                    charucoResults.markerIds);
+
+        if (charucoResults.charucoCorners.size() > cornerMin) {
+            charucoResults.boardFound = true;
+        }
+        return charucoResults;
+    }
+} // YACCP
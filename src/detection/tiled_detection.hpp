@@ -0,0 +1,30 @@
+#ifndef YACCP_SRC_DETECTION_TILED_DETECTION_HPP
+#define YACCP_SRC_DETECTION_TILED_DETECTION_HPP
+#include <opencv2/objdetect/charuco_detector.hpp>
+
+namespace YACCP::Utility {
+    struct CharucoResults;
+}
+
+namespace YACCP {
+    /**
+     * @brief Detect the board with the markers of overlapping tiles detected in parallel, see Utility::findBoard.
+     *
+     * Neighbouring tiles overlap by the given fraction of the larger side of the frame, so every marker up to that size
+     * lies completely inside at least one tile. The marker perimeter limits are scaled per tile so they stay the same
+     * in pixels as for the full frame. Larger markers are searched at the same time on a decimated copy of the frame
+     * and refined at full resolution. A marker found more than once keeps the tile detection furthest from a seam, the
+     * ChArUco corners are then interpolated on the full frame from the merged markers. When the overlap is too small to
+     * decimate the frame even once, the board is detected in a single full resolution pass.
+     *
+     * @param tiles Tiles per side of the frame, 1 detects in a single pass.
+     * @param overlap Overlap of neighbouring tiles as a fraction of the larger side of the frame.
+     */
+    [[nodiscard]] Utility::CharucoResults findBoardTiled(const cv::aruco::CharucoDetector& charucoDetector,
+                                                         const cv::Mat& gray,
+                                                         int cornerMin,
+                                                         int tiles,
+                                                         double overlap);
+} // YACCP
+
+#endif //YACCP_SRC_DETECTION_TILED_DETECTION_HPP
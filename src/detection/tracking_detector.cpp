@@ -0,0 +1,132 @@
+#include "tracking_detector.hpp"
+
+#include "board_detection.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+#include "../utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    // Copies of a detector share their implementation, both detectors are built anew so their parameters can differ.
+    TrackingDetector::TrackingDetector(const cv::aruco::CharucoDetector& charucoDetector,
+                                       const Config::DetectionConfig& detectionConfig) :
+        fullDetector_(charucoDetector.getBoard(),
+                      charucoDetector.getCharucoParameters(),
+                      charucoDetector.getDetectorParameters(),
+                      charucoDetector.getRefineParameters()),
+        roiDetector_(charucoDetector.getBoard(),
+                     charucoDetector.getCharucoParameters(),
+                     charucoDetector.getDetectorParameters(),
+                     charucoDetector.getRefineParameters()),
+        detectorParameters_(charucoDetector.getDetectorParameters()),
+        detectionConfig_(detectionConfig) {
+    }
+
+
+    Utility::CharucoResults TrackingDetector::findBoard(const cv::Mat& gray, const int cornerMin) {
+        // The frame size may change, the undistorted view of the viewer for example.
+        if (roi_) *roi_ &= cv::Rect({}, gray.size());
+
+        if (roi_ && !roi_->empty() && roi_->size() != gray.size()) {
+            if (auto results{findInRoi(gray, cornerMin)}) {
+                ++statistics_.hits;
+                track(*results, gray.size());
+                return std::move(*results);
+            }
+            ++statistics_.misses;
+        } else {
+            ++statistics_.untracked;
+        }
+
+        Utility::CharucoResults results{findBoardConfigured(fullDetector_, gray, cornerMin, detectionConfig_)};
+        track(results, gray.size());
+        return results;
+    }
+
+
+    void TrackingDetector::reset() {
+        roi_.reset();
+    }
+
+
+    const TrackingDetector::Statistics& TrackingDetector::statistics() const {
+        return statistics_;
+    }
+
+
+    std::optional<Utility::CharucoResults> TrackingDetector::findInRoi(const cv::Mat& gray, const int cornerMin) {
+        const cv::Rect roi{*roi_};
+        const double roiSize{static_cast<double>(std::max(roi.width, roi.height))};
+        const double imageSize{static_cast<double>(std::max(gray.cols, gray.rows))};
+
+        // The perimeter rates are relative to the searched image, the limits of the full frame are kept in pixels.
+        cv::aruco::DetectorParameters parameters{detectorParameters_};
+        const double minPerimeter{
+            std::max(detectorParameters_.minMarkerPerimeterRate * imageSize,
+                     GlobalVariables::trackingPerimeterSlack * minPerimeter_)
+        };
+        parameters.maxMarkerPerimeterRate = detectorParameters_.maxMarkerPerimeterRate * imageSize / roiSize;
+        parameters.minMarkerPerimeterRate = std::min(minPerimeter / roiSize, parameters.maxMarkerPerimeterRate);
+        if (parameters.useAruco3Detection) {
+            // The image is downscaled until the shortest expected marker side is the canonical side length.
+            parameters.minMarkerLengthRatioOriginalImg = static_cast<float>(std::min(minPerimeter / 4. / roiSize, 1.));
+        }
+        roiDetector_.setDetectorParameters(parameters);
+
+        Utility::CharucoResults results{Utility::findBoard(roiDetector_, gray(roi), cornerMin)};
+        if (!results.boardFound) return std::nullopt;
+
+        // A marker at an edge where the region cuts the frame may belong to a board that continues outside of it.
+        const auto margin{static_cast<float>(GlobalVariables::trackingEdgeMargin)};
+        const bool cutLeft{roi.x > 0};
+        const bool cutTop{roi.y > 0};
+        const bool cutRight{roi.x + roi.width < gray.cols};
+        const bool cutBottom{roi.y + roi.height < gray.rows};
+        for (const auto& marker : results.markerCorners) {
+            for (const auto& corner : marker) {
+                if ((cutLeft && corner.x < margin) ||
+                    (cutTop && corner.y < margin) ||
+                    (cutRight && corner.x > static_cast<float>(roi.width) - margin) ||
+                    (cutBottom && corner.y > static_cast<float>(roi.height) - margin)) {
+                    return std::nullopt;
+                }
+            }
+        }
+
+        const cv::Point2f offset{roi.tl()};
+        for (auto& corner : results.charucoCorners) corner += offset;
+        for (auto& marker : results.markerCorners) {
+            for (auto& corner : marker) corner += offset;
+        }
+        return results;
+    }
+
+
+    void TrackingDetector::track(const Utility::CharucoResults& results, const cv::Size imageSize) {
+        if (!results.boardFound || results.markerCorners.empty()) {
+            roi_.reset();
+            return;
+        }
+
+        std::vector<cv::Point2f> points;
+        minPerimeter_ = std::numeric_limits<double>::max();
+        for (const auto& marker : results.markerCorners) {
+            minPerimeter_ = std::min(minPerimeter_, cv::arcLength(marker, true));
+            points.insert(points.end(), marker.begin(), marker.end());
+        }
+
+        const cv::Rect bounds{cv::boundingRect(points)};
+        const auto padding{
+            static_cast<int>(std::lround(GlobalVariables::trackingRoiPadding * std::max(bounds.width, bounds.height)))
+        };
+        const cv::Rect padded{
+            bounds.x - padding, bounds.y - padding, bounds.width + 2 * padding, bounds.height + 2 * padding
+        };
+        roi_ = padded & cv::Rect({}, imageSize);
+    }
+} // YACCP
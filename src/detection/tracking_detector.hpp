@@ -0,0 +1,72 @@
+#ifndef YACCP_SRC_DETECTION_TRACKING_DETECTOR_HPP
+#define YACCP_SRC_DETECTION_TRACKING_DETECTOR_HPP
+#include "../config/detection.hpp"
+
+#include <cstdint>
+#include <optional>
+
+#include <opencv2/objdetect/charuco_detector.hpp>
+
+namespace YACCP::Utility {
+    struct CharucoResults;
+}
+
+namespace YACCP {
+    /**
+     * @brief Drop-in for Utility::findBoard that follows the board through consecutive frames of a single camera.
+     *
+     * The board is first searched in the bounding box of the previous detection, padded on every side. The minimum
+     * marker perimeter, and the aruco3 marker length ratio when enabled, are derived from the smallest marker seen
+     * last, so the search skips candidates far below the tracked marker size. The region result is only used when it
+     * has enough corners and no marker touches an edge where the region cuts the frame, otherwise the full frame is
+     * searched. The detectors are owned, use one instance per camera and thread.
+     */
+    class TrackingDetector {
+    public:
+        /**
+         * @param hits Detections found in the tracked region.
+         * @param misses Region searches that fell back to the full frame.
+         * @param untracked Full frame searches without a region to track.
+         */
+        struct Statistics {
+            std::uint64_t hits{};
+            std::uint64_t misses{};
+            std::uint64_t untracked{};
+        };
+
+        /**
+         * @param detectionConfig Detection mode of the full frame search, see findBoardConfigured.
+         */
+        explicit TrackingDetector(const cv::aruco::CharucoDetector& charucoDetector,
+                                  const Config::DetectionConfig& detectionConfig = {});
+
+        /**
+         * @brief Detect the board, see Utility::findBoard.
+         */
+        [[nodiscard]] Utility::CharucoResults findBoard(const cv::Mat& gray, int cornerMin);
+
+        /**
+         * @brief Forget the tracked region, the next search covers the full frame.
+         */
+        void reset();
+
+        [[nodiscard]] const Statistics& statistics() const;
+
+
+    private:
+        cv::aruco::CharucoDetector fullDetector_;
+        cv::aruco::CharucoDetector roiDetector_;
+        cv::aruco::DetectorParameters detectorParameters_;
+        Config::DetectionConfig detectionConfig_;
+
+        std::optional<cv::Rect> roi_;
+        double minPerimeter_{};
+        Statistics statistics_;
+
+        [[nodiscard]] std::optional<Utility::CharucoResults> findInRoi(const cv::Mat& gray, int cornerMin);
+
+        void track(const Utility::CharucoResults& results, cv::Size imageSize);
+    };
+} // YACCP
+
+#endif //YACCP_SRC_DETECTION_TRACKING_DETECTOR_HPP
@@ -54,9 +54,55 @@ namespace YACCP::Executor {
 
         if (*cliCmds.calibrationCmds.mono) {
             // cameraCalibration.monoCalibrate(cliCmdConfig.calibrationCmdConfig.jobId);
-            Calibration::monoCalibrate(charucoDetector, camDatas, fileConfig, jobPath);
+            Calibration::monoCalibrate(charucoDetector,
+                                       camDatas,
+                                       fileConfig,
+                                       jobPath,
+                                       {
+                                           cliCmdConfig.calibrationCmdConfig.outlierRounds,
+                                           cliCmdConfig.calibrationCmdConfig.outlierThreshold,
+                                           cliCmdConfig.calibrationCmdConfig.warmStart,
+                                           cliCmdConfig.calibrationCmdConfig.quickCheck,
+                                           cliCmdConfig.calibrationCmdConfig.previousJobId,
+                                           cliCmdConfig.calibrationCmdConfig.bootstrapRuns,
+                                           cliCmdConfig.calibrationCmdConfig.solver == "native"
+                                               ? Calibration::MonoSolver::Native
+                                               : Calibration::MonoSolver::OpenCv,
+                                           cliCmdConfig.calibrationCmdConfig.benchmark
+                                       });
+        } else if (*cliCmds.calibrationCmds.stereo && cliCmdConfig.calibrationCmdConfig.spanningTree) {
+            Calibration::spanningTreeStereoCalibrate(charucoDetector,
+                                                     camDatas,
+                                                     stereoCalibDatas,
+                                                     fileConfig,
+                                                     jobPath,
+                                                     cliCmdConfig.calibrationCmdConfig.loopClosures,
+                                                     cliCmdConfig.calibrationCmdConfig.bootstrapRuns);
         } else if (*cliCmds.calibrationCmds.stereo) {
-            Calibration::pairWiseStereoCalibrate(charucoDetector, camDatas, stereoCalibDatas, fileConfig, jobPath);
+            Calibration::pairWiseStereoCalibrate(charucoDetector,
+                                                 camDatas,
+                                                 stereoCalibDatas,
+                                                 fileConfig,
+                                                 jobPath,
+                                                 cliCmdConfig.calibrationCmdConfig.bootstrapRuns);
+        } else if (*cliCmds.calibrationCmds.joint) {
+            Calibration::jointCalibrate(charucoDetector,
+                                        camDatas,
+                                        stereoCalibDatas,
+                                        fileConfig,
+                                        jobPath,
+                                        cliCmdConfig.calibrationCmdConfig.fixIntrinsics);
+        } else if (*cliCmds.calibrationCmds.maps) {
+            Calibration::exportRemapTables(camDatas, stereoCalibDatas, jobPath);
+        } else if (*cliCmds.calibrationCmds.undistort) {
+            Calibration::undistortImages(camDatas, stereoCalibDatas, jobPath);
+        } else if (*cliCmds.calibrationCmds.checkDetection) {
+            Calibration::checkDetection(charucoDetector,
+                                        camDatas,
+                                        fileConfig,
+                                        jobPath,
+                                        cliCmdConfig.calibrationCmdConfig.pyramidLevels,
+                                        cliCmdConfig.calibrationCmdConfig.tiles);
         } else {
             std::cout << "base calibration called\n";
         }
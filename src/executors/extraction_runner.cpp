@@ -0,0 +1,84 @@
+#include "extraction_runner.hpp"
+
+#include "../utility.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+
+#include "../tools/event_frame_extractor.hpp"
+
+#include <cmath>
+#include <numeric>
+
+
+namespace YACCP::Executor {
+    // Frame indices of the frame_<n>.png images already in a raw camera directory.
+    static std::vector<int> recordedFrames(const std::filesystem::path& camPath) {
+        std::vector<int> frames;
+        if (!std::filesystem::exists(camPath)) return frames;
+
+        for (const auto& entry : std::filesystem::directory_iterator(camPath)) {
+            const std::string stem{entry.path().stem().string()};
+            if (entry.path().extension() != ".png" || !stem.starts_with("frame_")) continue;
+            frames.emplace_back(std::stoi(stem.substr(6)));
+        }
+        return frames;
+    }
+
+
+    int runExtraction(const CLI::CliCmdConfig& cliCmdConfig, const std::filesystem::path& path) {
+        const auto& extractionCmdConfig{cliCmdConfig.extractionCmdConfig};
+        const std::filesystem::path dataPath{path / "data"};
+        const std::filesystem::path jobPath{dataPath / extractionCmdConfig.jobId};
+
+        Utility::checkJobPath(dataPath, extractionCmdConfig.jobId);
+
+        // Load config from JSON file
+        nlohmann::json j = Utility::loadJobDataFromFile(jobPath);
+        const Config::FileConfig fileConfig{Utility::parseJsonToFileConfig(j)};
+
+        // The recorder writes a single event file per job, it belongs to the first Prophesee worker.
+        const Config::RecordingConfig::Worker* eventWorker{};
+        for (const auto& worker : fileConfig.recordingConfig.workers) {
+            if (std::holds_alternative<Config::Prophesee>(worker.configBackend)) {
+                eventWorker = &worker;
+                break;
+            }
+        }
+        if (eventWorker == nullptr)
+            throw std::runtime_error("Job " + extractionCmdConfig.jobId + " was not recorded with a Prophesee camera");
+
+        const auto& prophesee{std::get<Config::Prophesee>(eventWorker->configBackend)};
+        const std::filesystem::path eventFile{jobPath / GlobalVariables::eventFileName};
+        const std::filesystem::path camPath{
+            jobPath / "images" / "raw" / ("cam_" + std::to_string(eventWorker->placement))
+        };
+
+        const auto triggerIndex{TriggerIndex::loadOrBuild(eventFile, prophesee.fallingEdgePolarity)};
+        std::cout << "Found " << triggerIndex.entries().size() << " triggers in " << eventFile.filename() << "\n";
+
+        std::vector<int> frames{extractionCmdConfig.frames};
+        if (extractionCmdConfig.allTriggers) {
+            frames.resize(triggerIndex.entries().size());
+            std::iota(frames.begin(), frames.end(), 1);
+        } else if (frames.empty()) {
+            frames = recordedFrames(camPath);
+        }
+
+        // The recorded config sets the filters, the command line may override how the frames are rendered.
+        // Without an override the window of the live trigger frames is used, not the preview accumulation time.
+        Config::Prophesee extractionConfig{prophesee};
+        extractionConfig.accumulationTime = extractionCmdConfig.accumulationTime > 0
+                                                ? extractionCmdConfig.accumulationTime
+                                                : static_cast<int>(std::lround(
+                                                    1e6 / static_cast<double>(fileConfig.recordingConfig.fps)));
+        if (!extractionCmdConfig.representation.empty())
+            extractionConfig.frameRepresentation =
+                Config::stringToFrameRepresentation(extractionCmdConfig.representation);
+        if (extractionCmdConfig.blinkFrequency > 0)
+            extractionConfig.blinkFrequency = extractionCmdConfig.blinkFrequency;
+
+        EventFrameExtractor::extractFrames(eventFile, camPath, triggerIndex, frames, extractionConfig);
+
+        return 0;
+    }
+} // YACCP::Executor
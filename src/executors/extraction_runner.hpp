@@ -0,0 +1,9 @@
+#ifndef YACCP_SRC_EXECUTOR_EXTRACTION_RUNNER_HPP
+#define YACCP_SRC_EXECUTOR_EXTRACTION_RUNNER_HPP
+#include "../cli/orchestrator.hpp"
+
+namespace YACCP::Executor {
+    int runExtraction(const CLI::CliCmdConfig& cliCmdConfig, const std::filesystem::path& path);
+} // YACCP::Executor
+
+#endif //YACCP_SRC_EXECUTOR_EXTRACTION_RUNNER_HPP
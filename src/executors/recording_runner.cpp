@@ -1,9 +1,12 @@
 #include "recording_runner.hpp"
 
+#include "../camera_calibration.hpp"
 #include "../utility.hpp"
 
 #include "../global_variables/program_defaults.hpp"
 
+#include "../recoding/calibration_estimator.hpp"
+
 #include "../recoding/recorders/basler_cam_worker.hpp"
 #include "../recoding/recorders/prophesee_cam_worker.hpp"
 
@@ -134,6 +137,23 @@ namespace YACCP::Executor {
                 fileConfig.detectionConfig.openCvArucoDictionaryId = jsonConfig.detectionConfig.openCvArucoDictionaryId;
             }
 
+            // Load the remap tables of a previous calibration to undistort the live view with.
+            std::vector<std::unique_ptr<Calibration::RemapTable> > remapTables;
+            if (!cliCmdConfig.recordingCmdConfig.undistortJobId.empty()) {
+                Utility::checkJobPath(dataPath, cliCmdConfig.recordingCmdConfig.undistortJobId);
+
+                for (auto i{0}; i < static_cast<int>(fileConfig.recordingConfig.workers.size()); ++i) {
+                    const std::filesystem::path remapPath{
+                        Calibration::remapTablePath(dataPath / cliCmdConfig.recordingCmdConfig.undistortJobId, i)
+                    };
+                    if (!std::filesystem::exists(remapPath))
+                        throw std::runtime_error("Remap table " + remapPath.string() +
+                                                 " does not exist, did you run calibrate maps for that job?");
+
+                    remapTables.emplace_back(std::make_unique<Calibration::RemapTable>(remapPath));
+                }
+            }
+
             Utility::AlternativeBuffer buffer;
             buffer.enable();
 
@@ -157,6 +177,8 @@ namespace YACCP::Executor {
             std::vector<std::jthread> threads;
             std::vector<std::unique_ptr<CameraWorker> > cameraWorkers(numCams);
             moodycamel::ReaderWriterQueue<ValidatedCornersData> valCornersQ{100};
+            moodycamel::BlockingReaderWriterQueue<ValidatedCornersData> estimatorQ{100};
+            moodycamel::ReaderWriterQueue<CalibrationEstimate> estimateQ{100};
 
             (void)std::filesystem::create_directories(jobPath / "images" / "raw");
 
@@ -175,7 +197,8 @@ namespace YACCP::Executor {
                                                                          fileConfig.recordingConfig,
                                                                          backend,
                                                                          index,
-                                                                         jobPath);
+                                                                         jobPath,
+                                                                         charucoDetector);
                                } else if constexpr (std::is_same_v<T, Config::Prophesee>) {
                                    cameraWorkers[index] =
                                        std::make_unique<PropheseeCamWorker>(stopSource,
@@ -183,7 +206,8 @@ namespace YACCP::Executor {
                                                                             fileConfig.recordingConfig,
                                                                             backend,
                                                                             index,
-                                                                            jobPath);
+                                                                            jobPath,
+                                                                            charucoDetector);
                                }
                            },
                            fileConfig.recordingConfig.workers[i].configBackend);
@@ -244,11 +268,27 @@ namespace YACCP::Executor {
                 camDatas,
                 charucoDetector,
                 valCornersQ,
+                estimateQ,
                 jobPath,
                 fileConfig.detectionConfig.cornerMin,
+                fileConfig.detectionConfig,
+                remapTables
             };
             threads.emplace_back(&VideoViewer::start, &videoViewer);
 
+            // Start the calibrationEstimator, only when enabled since it continuously re-solves the intrinsics.
+            CalibrationEstimator calibrationEstimator{
+                stopSource,
+                camDatas,
+                charucoDetector,
+                estimatorQ,
+                estimateQ,
+                fileConfig.recordingConfig
+            };
+            if (fileConfig.recordingConfig.estimateCalibration) {
+                threads.emplace_back(&CalibrationEstimator::start, &calibrationEstimator);
+            }
+
             // Start the detectionValidator
             DetectionValidator detectionValidator{
                 stopSource,
@@ -256,7 +296,10 @@ namespace YACCP::Executor {
                 charucoDetector,
                 valCornersQ,
                 jobPath,
-                fileConfig.detectionConfig.cornerMin
+                fileConfig.detectionConfig.cornerMin,
+                fileConfig.detectionConfig,
+                fileConfig.recordingConfig.burstSize,
+                fileConfig.recordingConfig.estimateCalibration ? &estimatorQ : nullptr
             };
             threads.emplace_back(&DetectionValidator::start, &detectionValidator);
 
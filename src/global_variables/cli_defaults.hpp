@@ -5,6 +5,13 @@ namespace YACCP::GlobalVariables {
     // Default boardCreationCmd variables.
     inline constexpr auto generateImage{true};
     inline constexpr auto generateVideo{false};
+
+    // Default calibrationCmd variables.
+    inline constexpr auto loopClosures{0};
+    inline constexpr auto outlierRounds{0}; // Outlier rejection is opt-in
+    inline constexpr auto outlierThreshold{3.};
+    inline constexpr auto bootstrapRuns{0};
+    inline constexpr auto monoSolver{"opencv"};
 }
 
 #endif //YACCP_SRC_GLOBAL_VARIABLES_CLI_DEFAULTS_HPP
\ No newline at end of file
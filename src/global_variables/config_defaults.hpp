@@ -9,17 +9,43 @@ namespace YACCP::GlobalVariables {
     inline constexpr auto markerPixelLength{70};
     inline constexpr auto borderBits{1};
     inline constexpr auto videoFps{60};
+    inline constexpr auto blinkFrequency{videoFps / 2.}; // Hz, the board and a blank frame alternate every frame
 
     // Default [detection] variables
     inline constexpr auto charucoDictionary{8};
     inline constexpr auto minCornerFraction{.125F};
+    inline constexpr auto pyramidLevels{0}; // Full resolution detection
+    inline constexpr auto maxPyramidLevels{4};
+    inline constexpr auto detectionTiles{1}; // Per side, a single tile detects in one pass
+    inline constexpr auto maxDetectionTiles{8};
+    inline constexpr auto tileOverlap{.1}; // Of the larger side of the frame
 
     // Default [recording] variables
     inline constexpr auto recordingFps{30};
     inline constexpr auto detectionInterval{2}; // seconds
     inline constexpr auto accumulationTime{33333};
+    inline constexpr auto frameRepresentation{"metavision"};
+    inline constexpr auto timeSurfaceDecay{5000}; // microseconds
+    inline constexpr auto frameSlicing{"fixed"};
+    inline constexpr auto sliceEventCount{50000};
+    inline constexpr auto sliceCandidates{5};
     inline constexpr auto ercEnabled{false};
     inline constexpr auto etfEnabled{false};
+    inline constexpr auto polarityFilter{1}; // ON events
+    inline constexpr auto activityThreshold{0}; // microseconds, disabled
+    inline constexpr auto governorEnabled{false};
+    inline constexpr auto governorMaxLag{50}; // milliseconds
+    inline constexpr auto estimateCalibration{false};
+    inline constexpr auto estimateInterval{10}; // Validated views per camera between re-solves
+    inline constexpr auto autoStop{false};
+    inline constexpr auto autoStopThreshold{.005}; // Relative change of the intrinsics
+    inline constexpr auto motionGate{false};
+    inline constexpr auto gateTimeout{2000}; // milliseconds
+    inline constexpr auto noveltyCapture{false};
+    inline constexpr auto noveltyCoverage{.25}; // Fraction of the corners
+    inline constexpr auto noveltyDisplacement{.05}; // Of the image diagonal
+    inline constexpr auto noveltyMinSpacing{500}; // milliseconds
+    inline constexpr auto burstSize{1};
 
     // Default [view] variables
     inline constexpr auto camViewsHorizontal{3};
@@ -1,12 +1,63 @@
 #ifndef YACCP_SRC_GLOBAL_VARIABLES_PROGRAM_DEFAULTS_HPP
 #define YACCP_SRC_GLOBAL_VARIABLES_PROGRAM_DEFAULTS_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 
 namespace YACCP::GlobalVariables {
     inline constexpr auto jobDataFileName{"job_data.json"};
     inline constexpr auto configFileName{"config.toml"};
     inline constexpr auto boardImageFileName{"board.png"};
     inline constexpr auto boardVideoFileName{"board_video.mp4"};
+    inline constexpr auto eventFileName{"event_file.raw"};
+    inline constexpr auto triggerIndexExtension{".yidx"};
+    inline constexpr auto eventRingSlack{50000}; // microseconds
+    inline constexpr auto eventRingMaxRetain{500000}; // microseconds
+    inline constexpr auto eventCountScale{64.}; // Grey levels per event
+    inline constexpr auto eventPolarityScale{32.}; // Grey levels per ON minus OFF event
+    inline constexpr auto sliceWindowFactor{4}; // Longest and shortest adaptive window relative to the fixed one
+    inline constexpr auto blinkPhaseBins{64};
+    inline constexpr auto blinkGateFraction{.125}; // Of the blink period, per transition
+    inline constexpr auto boardVideoDuration{10}; // seconds
     inline constexpr auto windowMargins{500};
+    inline constexpr auto estimatorMinViews{5};
+    inline constexpr auto autoStopStableRounds{3};
+    inline constexpr auto coverageCellSize{16}; // pixels
+    inline constexpr auto coverageAlpha{.4};
+    inline constexpr auto remapDirName{"maps"};
+    inline constexpr auto remapFileExtension{".yrmap"};
+    inline constexpr auto remapTileRows{32};
+    inline constexpr auto rectifiedLineSpacing{40}; // pixels
+    inline constexpr std::size_t calibrationMinViews{5};
+    inline constexpr std::size_t outlierMinCorners{6};
+    inline constexpr auto outlierMinThreshold{.5}; // pixels
+    inline constexpr auto quickCheckMaxDrift{.2}; // pixels
+    inline constexpr std::uint64_t bootstrapSeed{0x5eed};
+    inline constexpr auto governorLogFileName{"event_rate_governor.csv"};
+    inline constexpr auto eventFilterStatsFileName{"event_filter_stats.csv"};
+    inline constexpr auto motionGateLogFileName{"motion_gate.csv"};
+    inline constexpr auto motionGateDownscale{4};
+    inline constexpr auto requestLeadFrames{2}; // The slaves have to receive a request before its trigger
+    inline constexpr std::chrono::milliseconds motionGateHistogramStep{100};
+    inline constexpr auto eventRateWindow{10000}; // microseconds
+    inline constexpr auto noveltyDownscale{2};
+    inline constexpr auto noveltyFrameStride{3}; // Frames between preview detections
+    inline constexpr std::size_t noveltyMinCorners{6};
+    inline constexpr auto noveltyCellSize{64}; // pixels
+    inline constexpr auto burstScoreDownscale{2};
+    inline constexpr auto acceptanceFileName{"acceptance.csv"};
+    inline constexpr auto acceptanceCellSize{44}; // pixels
+    inline constexpr auto acceptanceTargetViews{30}; // Views at which a cell of the acceptance matrix turns green
+    inline constexpr auto trackingFileName{"detection_tracking.csv"};
+    inline constexpr auto trackingRoiPadding{.5}; // Of the larger side of the previous detection, per side
+    inline constexpr auto trackingPerimeterSlack{.5}; // Smallest searched marker perimeter relative to the last one
+    inline constexpr auto trackingEdgeMargin{4}; // pixels
+    inline constexpr auto tileCoarseMinPerimeter{80}; // Smallest marker perimeter on the decimated frame, pixels
+    inline constexpr std::chrono::milliseconds governorInterval{200};
+    inline constexpr auto governorThrottleFactor{.8};
+    inline constexpr auto governorMinErcFraction{.1};
+    inline constexpr auto governorMaxDecimation{16};
+    inline constexpr auto governorRelaxLoad{.5};
 }
 
 #endif //YACCP_SRC_GLOBAL_VARIABLES_PROGRAM_DEFAULTS_HPP
\ No newline at end of file
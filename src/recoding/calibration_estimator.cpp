@@ -0,0 +1,127 @@
+#include "calibration_estimator.hpp"
+
+#include "job_data.hpp"
+
+#include "../utility.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+
+#include <opencv2/calib3d.hpp>
+
+namespace YACCP {
+    CalibrationEstimator::CalibrationEstimator(std::stop_source stopSource,
+                                               std::vector<CamData>& camDatas,
+                                               const cv::aruco::CharucoDetector& charucoDetector,
+                                               moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>& cornersQ,
+                                               moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ,
+                                               const Config::RecordingConfig& recordingConfig) :
+        stopSource_(stopSource),
+        stopToken_(stopSource.get_token()),
+        camDatas_(camDatas),
+        charucoDetector_(charucoDetector),
+        cornersQ_(cornersQ),
+        estimateQ_(estimateQ),
+        recordingConfig_(recordingConfig) {
+    }
+
+
+    CalibrationEstimate CalibrationEstimator::estimate(const int camId, CamState& camState) const {
+        CalibrationEstimate calibrationEstimate{};
+        calibrationEstimate.camId = camId;
+        calibrationEstimate.views = static_cast<int>(camState.objPoints.size());
+
+        // Warm-start from the previous solution once there is one.
+        const bool warmStart{!camState.cameraMatrix.empty()};
+        const int flags{warmStart ? cv::CALIB_USE_INTRINSIC_GUESS : 0};
+        cv::Mat cameraMatrix{warmStart ? camState.cameraMatrix.clone() : cv::Mat()};
+        cv::Mat distCoeffs{warmStart ? camState.distCoeffs.clone() : cv::Mat()};
+
+        calibrationEstimate.reprojError = cv::calibrateCamera(camState.objPoints,
+                                                              camState.imgPoints,
+                                                              camDatas_[camId].info.resolution,
+                                                              cameraMatrix,
+                                                              distCoeffs,
+                                                              cv::noArray(),
+                                                              cv::noArray(),
+                                                              flags);
+
+        // Largest relative change of the focal lengths and principal point.
+        calibrationEstimate.parameterDelta = 1.;
+        if (warmStart) {
+            calibrationEstimate.parameterDelta = 0.;
+            for (const auto& [row, col] : {std::pair{0, 0}, std::pair{1, 1}, std::pair{0, 2}, std::pair{1, 2}}) {
+                const double previous{camState.cameraMatrix.at<double>(row, col)};
+                const double current{cameraMatrix.at<double>(row, col)};
+                calibrationEstimate.parameterDelta = std::max(calibrationEstimate.parameterDelta,
+                                                              std::abs(current - previous) / std::abs(previous));
+            }
+        }
+
+        calibrationEstimate.stable = calibrationEstimate.parameterDelta < recordingConfig_.autoStopThreshold;
+        camState.stableRounds = calibrationEstimate.stable ? camState.stableRounds + 1 : 0;
+        camState.cameraMatrix = cameraMatrix;
+        camState.distCoeffs = distCoeffs;
+
+        return calibrationEstimate;
+    }
+
+
+    void CalibrationEstimator::start() {
+        // The estimate is a convenience for the operator, it should never slow down recording or validation.
+        Utility::lowerThreadPriority();
+
+        const cv::aruco::CharucoBoard& board{charucoDetector_.getBoard()};
+        std::vector<CamState> camStates(camDatas_.size());
+
+        while (!stopToken_.stop_requested()) {
+            ValidatedCornersData validatedCornersData;
+            if (!cornersQ_.wait_dequeue_timed(validatedCornersData, std::chrono::milliseconds(100))) {
+                continue;
+            }
+
+            CamState& camState{camStates[validatedCornersData.camId]};
+            std::vector<cv::Point3f> objPoints;
+            std::vector<cv::Point2f> imgPoints;
+            board.matchImagePoints(validatedCornersData.charucoCorners,
+                                   validatedCornersData.charucoIds,
+                                   objPoints,
+                                   imgPoints);
+            if (objPoints.size() < 6) continue;
+
+            camState.objPoints.emplace_back(std::move(objPoints));
+            camState.imgPoints.emplace_back(std::move(imgPoints));
+            ++camState.newViews;
+
+            // Only re-solve after enough new views have been gathered.
+            if (camState.newViews < recordingConfig_.estimateInterval ||
+                static_cast<int>(camState.objPoints.size()) < GlobalVariables::estimatorMinViews) {
+                continue;
+            }
+            camState.newViews = 0;
+
+            try {
+                (void)estimateQ_.enqueue(estimate(validatedCornersData.camId, camState));
+            }
+            catch (const cv::Exception&) {
+                // A degenerate set of views is not fatal, the next estimate will have more data.
+                camState.stableRounds = 0;
+                continue;
+            }
+
+            if (!recordingConfig_.autoStop) continue;
+
+            const bool allStable{
+                std::ranges::all_of(camStates,
+                                    [](const CamState& state) {
+                                        return state.stableRounds >= GlobalVariables::autoStopStableRounds;
+                                    })
+            };
+            if (allStable) {
+                std::cout << "Calibration estimates of all cameras have settled, stopping the recording.\n";
+                stopSource_.request_stop();
+            }
+        }
+    }
+} // YACCP
@@ -0,0 +1,47 @@
+#ifndef YACCP_SRC_RECORDING_CALIBRATION_ESTIMATOR_HPP
+#define YACCP_SRC_RECORDING_CALIBRATION_ESTIMATOR_HPP
+#include "video_viewer.hpp"
+
+namespace YACCP {
+    /**
+     * @brief Background estimator that re-solves the intrinsics of every camera while recording.
+     *
+     * Consumes the validated corners as they are accepted by the DetectionValidator and every estimateInterval new
+     * views re-runs the calibration of that camera, warm-started from its previous solution. The results are
+     * published to the VideoViewer, optionally the recording is stopped once all estimates have settled.
+     */
+    class CalibrationEstimator {
+    public:
+        CalibrationEstimator(std::stop_source stopSource,
+                             std::vector<CamData>& camDatas,
+                             const cv::aruco::CharucoDetector& charucoDetector,
+                             moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>& cornersQ,
+                             moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ,
+                             const Config::RecordingConfig& recordingConfig);
+
+        void start();
+
+
+    private:
+        struct CamState {
+            std::vector<std::vector<cv::Point3f> > objPoints;
+            std::vector<std::vector<cv::Point2f> > imgPoints;
+            cv::Mat cameraMatrix;
+            cv::Mat distCoeffs;
+            int newViews{};
+            int stableRounds{};
+        };
+
+        std::stop_source stopSource_;
+        std::stop_token stopToken_;
+        std::vector<CamData>& camDatas_;
+        const cv::aruco::CharucoDetector charucoDetector_;
+        moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>& cornersQ_;
+        moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ_;
+        const Config::RecordingConfig& recordingConfig_;
+
+        [[nodiscard]] CalibrationEstimate estimate(int camId, CamState& camState) const;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_CALIBRATION_ESTIMATOR_HPP
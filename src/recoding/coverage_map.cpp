@@ -0,0 +1,110 @@
+#include "coverage_map.hpp"
+
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    CoverageMap::CoverageMap(const cv::Size resolution, const int cellSize) :
+        resolution_(resolution),
+        cellSize_(cellSize),
+        counts_(cv::Mat::zeros((resolution.height + cellSize - 1) / cellSize,
+                               (resolution.width + cellSize - 1) / cellSize,
+                               CV_32FC1)),
+        hullMask_(counts_.size(), CV_8UC1) {
+    }
+
+
+    void CoverageMap::add(const std::vector<cv::Point2f>& corners) {
+        if (corners.size() < 3) return;
+
+        std::vector<cv::Point2f> hull;
+        cv::convexHull(corners, hull);
+
+        // Rasterise the hull in cell coordinates.
+        std::vector<cv::Point> cellHull;
+        cellHull.reserve(hull.size());
+        for (const auto& point : hull) cellHull.emplace_back(cellOf(point));
+
+        hullMask_.setTo(cv::Scalar{0.});
+        cv::fillConvexPoly(hullMask_, cellHull, cv::Scalar{255.});
+        cv::add(counts_, cv::Scalar{1.}, counts_, hullMask_);
+        dirty_ = true;
+    }
+
+
+    void CoverageMap::clear() {
+        counts_.setTo(cv::Scalar{0.});
+        heatmap_.release();
+        heatmapMask_.release();
+        coveredRects_.clear();
+        dirty_ = false;
+    }
+
+
+    void CoverageMap::updateHeatmap() {
+        double maxCount{};
+        cv::minMaxLoc(counts_, nullptr, &maxCount);
+
+        cv::Mat normalised;
+        counts_.convertTo(normalised, CV_8UC1, maxCount > 0. ? 255. / maxCount : 0.);
+
+        cv::Mat colourCells;
+        cv::applyColorMap(normalised, colourCells, cv::COLORMAP_JET);
+
+        // Scale the cells up to the camera resolution once, instead of on every displayed frame.
+        cv::resize(colourCells, heatmap_, resolution_, 0., 0., cv::INTER_NEAREST);
+        const cv::Mat coveredCells{counts_ > 0.};
+        cv::resize(coveredCells, heatmapMask_, resolution_, 0., 0., cv::INTER_NEAREST);
+
+        // Blend only the covered regions, which early in a recording are a small part of the frame.
+        std::vector<std::vector<cv::Point> > contours;
+        cv::findContours(coveredCells, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        coveredRects_.clear();
+        for (const auto& contour : contours) {
+            cv::Rect cells{cv::boundingRect(contour)};
+            // Overlapping boxes would blend their shared pixels twice, merge them.
+            for (auto it{coveredRects_.begin()}; it != coveredRects_.end();) {
+                if ((*it & cells).empty()) {
+                    ++it;
+                    continue;
+                }
+                cells |= *it;
+                coveredRects_.erase(it);
+                it = coveredRects_.begin();
+            }
+            coveredRects_.emplace_back(cells);
+        }
+        for (auto& rect : coveredRects_) {
+            rect = cv::Rect(rect.x * cellSize_, rect.y * cellSize_, rect.width * cellSize_, rect.height * cellSize_) &
+                cv::Rect({}, resolution_);
+        }
+        dirty_ = false;
+    }
+
+
+    void CoverageMap::render(cv::Mat& tile, const double alpha) {
+        if (dirty_) updateHeatmap();
+        if (heatmap_.empty() || tile.size() != heatmap_.size()) return;
+
+        for (const auto& rect : coveredRects_) {
+            cv::Mat region{tile(rect)};
+            cv::addWeighted(region, 1. - alpha, heatmap_(rect), alpha, 0., blended_);
+            blended_.copyTo(region, heatmapMask_(rect));
+        }
+    }
+
+
+    float CoverageMap::countAt(const cv::Point2f point) const {
+        const cv::Point cell{cellOf(point)};
+        return counts_.at<float>(std::clamp(cell.y, 0, counts_.rows - 1), std::clamp(cell.x, 0, counts_.cols - 1));
+    }
+
+
+    cv::Point CoverageMap::cellOf(const cv::Point2f point) const {
+        return {
+            cvFloor(point.x / static_cast<float>(cellSize_)),
+            cvFloor(point.y / static_cast<float>(cellSize_))
+        };
+    }
+} // YACCP
@@ -0,0 +1,61 @@
+#ifndef YACCP_SRC_RECORDING_COVERAGE_MAP_HPP
+#define YACCP_SRC_RECORDING_COVERAGE_MAP_HPP
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace YACCP {
+    /**
+     * @brief Low resolution accumulator of the image area covered by validated board detections of a single camera.
+     *
+     * Every validated detection increments the cells under the convex hull of its corners. The colour-mapped heatmap
+     * and the bounding boxes of the covered regions are only regenerated when the counts change, drawing it onto a
+     * frame only blends the pixels inside these boxes.
+     */
+    class CoverageMap {
+    public:
+        /**
+         * @param resolution Resolution of the camera.
+         * @param cellSize Width and height of a single coverage cell in pixels.
+         */
+        CoverageMap(cv::Size resolution, int cellSize);
+
+        void add(const std::vector<cv::Point2f>& corners);
+
+        void clear();
+
+        /**
+         * @brief Blend the heatmap into a tile, cells without coverage are left untouched.
+         *
+         * @param tile BGR image with the resolution of the camera, usually an ROI of the composed frame.
+         * @param alpha Weight of the heatmap.
+         */
+        void render(cv::Mat& tile, double alpha);
+
+        /**
+         * @brief Amount of detections that covered the cell containing the given pixel.
+         */
+        [[nodiscard]] float countAt(cv::Point2f point) const;
+
+
+    private:
+        cv::Size resolution_;
+        int cellSize_;
+        cv::Mat counts_;
+        cv::Mat hullMask_;
+        cv::Mat heatmap_;
+        cv::Mat heatmapMask_;
+        cv::Mat blended_;
+        std::vector<cv::Rect> coveredRects_;
+        bool dirty_{false};
+
+        void updateHeatmap();
+
+        /**
+         * @brief Cell containing the given pixel, shared by add and countAt so both address the same cells.
+         */
+        [[nodiscard]] cv::Point cellOf(cv::Point2f point) const;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_COVERAGE_MAP_HPP
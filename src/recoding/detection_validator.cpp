@@ -1,9 +1,15 @@
 #include "detection_validator.hpp"
 
 #include <algorithm>
+#include <limits>
+#include <optional>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
 
 #include "job_data.hpp"
 
+#include "../global_variables/program_defaults.hpp"
 #include "../utility.hpp"
 
 namespace YACCP {
@@ -12,139 +18,266 @@ namespace YACCP {
                                            const cv::aruco::CharucoDetector& charucoDetector,
                                            moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ,
                                            const std::filesystem::path& outputPath,
-                                           float cornerMin) :
+                                           float cornerMin,
+                                           const Config::DetectionConfig& detectionConfig,
+                                           const int burstSize,
+                                           moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>* estimatorQ) :
         stopSource_(stopSource),
         stopToken_(stopSource.get_token()),
         camDatas_(camDatas),
         charucoDetector_(charucoDetector),
         valCornersQ_(valCornersQ),
         outputPath_(outputPath),
-        cornerMin_(cornerMin) {
+        cornerMin_(cornerMin),
+        detectionConfig_(detectionConfig),
+        burstSize_(burstSize),
+        estimatorQ_(estimatorQ) {
     }
 
 
     void DetectionValidator::start() {
         std::vector<VerifyTask> verifyTasks(camDatas_.size());
-        std::vector<std::vector<cv::Point2f> > allCharucoCorners(camDatas_.size());
-        cv::Size boardSize = charucoDetector_.getBoard().getChessboardSize();
-        int validatedImagePair{};
-        int validatedCorners{};
-
-        int cornerAmount = (boardSize.width - 1) * (boardSize.height - 1);
-
-        while (!stopToken_.stop_requested()) {
-            bool skipLoop{false};
-            std::vector<int> camTaskCorrect{};
-            bool taskIdsCorrect{false};
-
-            // Keep dequeuing until all cameras have the same task id.
-            do {
-                // Get a new task from every camera, skip cameras that are already correct (have the highest taskID/frame index).
-                for (auto i{0}; i < camDatas_.size(); ++i) {
-                    if (std::ranges::find(camTaskCorrect, i) != camTaskCorrect.end()) {
-                        continue;
-                    }
-
-                    while (!stopToken_.stop_requested() &&
-                           !camDatas_[i].runtimeData.frameVerifyQ.wait_dequeue_timed(
-                               verifyTasks[i],
-                               std::chrono::milliseconds(100)
-                               ));
-                }
+        allCharucoCorners_.resize(camDatas_.size());
+        allCharucoIds_.resize(camDatas_.size());
+        acceptance_.assign(camDatas_.size(), std::vector<int>(camDatas_.size()));
+        // Copies would share the detectors of the original, every camera gets its own.
+        trackingDetectors_.reserve(camDatas_.size());
+        for (std::size_t i{0}; i < camDatas_.size(); ++i) {
+            trackingDetectors_.emplace_back(charucoDetector_, detectionConfig_);
+        }
 
-                if (stopToken_.stop_requested()) {
-                    return;
-                }
+        // The pairs are appended as they are accepted, so the record survives an aborted recording.
+        acceptanceFile_.open(outputPath_ / GlobalVariables::acceptanceFileName, std::ios::trunc);
+        acceptanceFile_ << "frame,cam_left,cam_right,corners\n";
 
-                // Get the largest task ID.
-                int maxElement{};
-                for (auto i{0}; i < camDatas_.size(); ++i) {
-                    maxElement = std::max(verifyTasks[i].id, maxElement);
-                }
+        // The master sends a frame index it skipped without a frame, such a set is not synchronised.
+        const auto isComplete{
+            [](const std::vector<VerifyTask>& tasks) {
+                return std::ranges::none_of(tasks, [](const VerifyTask& task) { return task.frame.empty(); });
+            }
+        };
 
-                // Check which cameras have the largest task ID.
-                for (auto i{0}; i < camDatas_.size(); ++i) {
-                    if (verifyTasks[i].id == maxElement) {
-                        (void)camTaskCorrect.emplace_back(i);
-                    }
-                }
-                // If all cameras have the same task id, we are done and can continue with the detection.
-                if (camTaskCorrect.size() == camDatas_.size()) {
-                    taskIdsCorrect = true;
-                }
-            } while (!taskIdsCorrect);
-
-            cv::Mat grayFrame;
-            cv::cvtColor(verifyTasks[0].frame, grayFrame, cv::COLOR_BGR2GRAY);
-            Utility::CharucoResults charucoResults{
-                Utility::findBoard(charucoDetector_,
-                                   grayFrame,
-                                   std::floor(
-                                       static_cast<float>(cornerAmount) * cornerMin_))
-            };
-            if (!charucoResults.boardFound) continue;
-
-            allCharucoCorners[0] = charucoResults.charucoCorners;
-            std::vector vec1{charucoResults.charucoIds};
-
-            if (camDatas_.size() > 1) {
-                std::vector<int> vec2;
-
-                for (auto i{1}; i < camDatas_.size(); ++i) {
-                    cv::cvtColor(verifyTasks[i].frame, grayFrame, cv::COLOR_BGR2GRAY);
-                    charucoResults = Utility::findBoard(charucoDetector_,
-                                                        grayFrame,
-                                                        std::floor(
-                                                            static_cast<float>(cornerAmount) * cornerMin_));
-                    if (!charucoResults.boardFound) {
-                        continue;
-                    }
-                    allCharucoCorners[i] = charucoResults.charucoCorners;
-
-                    vec2 = charucoResults.charucoIds;
-                    vec1 = Utility::intersection(vec1, vec2);
-
-                    if (static_cast<float>(vec1.size()) < std::floor(
-                            static_cast<float>(cornerAmount) * cornerMin_)) {
-                        skipLoop = true;
-                        break;
-                    }
-                }
-            } else {
-                if (static_cast<float>(vec1.size()) < std::floor(
-                        static_cast<float>(cornerAmount) * cornerMin_)) {
-                    skipLoop = true;
+        if (burstSize_ == 1) {
+            while (dequeueSet(verifyTasks)) {
+                if (isComplete(verifyTasks)) validateSet(verifyTasks);
+            }
+            writeTrackingStatistics();
+            return;
+        }
+
+        // The sets of a burst are swapped in and out of these slots, so their storage is reused between bursts.
+        std::vector<std::vector<VerifyTask> > burst(burstSize_, std::vector<VerifyTask>(camDatas_.size()));
+        scoreBuffers_.assign(burstSize_, std::vector<ScoreBuffers>(camDatas_.size()));
+        std::size_t count{0};
+        std::optional<int> burstStart;
+
+        while (dequeueSet(verifyTasks)) {
+            const int id{verifyTasks[0].id};
+            // A set beyond the current burst means frames of the burst were lost, finish it with what arrived.
+            if (burstStart && id >= *burstStart + burstSize_) {
+                if (count > 0) validateBestSet(burst, count);
+                count = 0;
+                burstStart.reset();
+            }
+            if (!burstStart) burstStart = id;
+
+            if (isComplete(verifyTasks)) std::swap(burst[count++], verifyTasks);
+            if (id == *burstStart + burstSize_ - 1) {
+                if (count > 0) validateBestSet(burst, count);
+                count = 0;
+                burstStart.reset();
+            }
+        }
+        writeTrackingStatistics();
+    }
+
+
+    bool DetectionValidator::dequeueSet(std::vector<VerifyTask>& verifyTasks) {
+        std::vector<int> camTaskCorrect{};
+        bool taskIdsCorrect{false};
+
+        // Keep dequeuing until all cameras have the same task id.
+        do {
+            // Get a new task from every camera, skip cameras that are already correct (have the highest taskID/frame index).
+            for (auto i{0}; i < camDatas_.size(); ++i) {
+                if (std::ranges::find(camTaskCorrect, i) != camTaskCorrect.end()) {
+                    continue;
                 }
+
+                while (!stopToken_.stop_requested() &&
+                       !camDatas_[i].runtimeData.frameVerifyQ.wait_dequeue_timed(
+                           verifyTasks[i],
+                           std::chrono::milliseconds(100)
+                           ));
             }
 
-            if (skipLoop) {
-                continue;
+            if (stopToken_.stop_requested()) {
+                return false;
             }
 
-            validatedImagePair += 1;
-            validatedCorners += static_cast<int>(vec1.size());
+            // Get the largest task ID.
+            int maxElement{};
+            for (auto i{0}; i < camDatas_.size(); ++i) {
+                maxElement = std::max(verifyTasks[i].id, maxElement);
+            }
 
+            // Check which cameras have the largest task ID.
+            camTaskCorrect.clear();
             for (auto i{0}; i < camDatas_.size(); ++i) {
-                // Save image.
-                // TODO: Make path configurable.
+                if (verifyTasks[i].id == maxElement) {
+                    (void)camTaskCorrect.emplace_back(i);
+                }
+            }
+            // If all cameras have the same task id, we are done and can continue with the detection.
+            if (camTaskCorrect.size() == camDatas_.size()) {
+                taskIdsCorrect = true;
+            }
+        } while (!taskIdsCorrect);
+
+        return true;
+    }
 
-                std::filesystem::path imagePath = outputPath_ / ("images/raw/cam_" + std::to_string(i));
-                std::string imageName = "frame_" + std::to_string(verifyTasks[i].id) + ".png";
-                (void)std::filesystem::create_directories(imagePath);
 
-                cv::imwrite((imagePath / imageName).string(), verifyTasks[i].frame);
+    void DetectionValidator::validateSet(const std::vector<VerifyTask>& verifyTasks) {
+        const cv::Size boardSize{charucoDetector_.getBoard().getChessboardSize()};
+        const int cornerAmount{(boardSize.width - 1) * (boardSize.height - 1)};
+        const auto cornerThreshold{static_cast<int>(std::floor(static_cast<float>(cornerAmount) * cornerMin_))};
+        const auto cams{static_cast<int>(camDatas_.size())};
 
-                // Enqueue bounding box data for viewing.
-                ValidatedCornersData validatedCornersData;
+        cv::Mat grayFrame;
+        std::vector<bool> accepted(cams);
+        for (auto i{0}; i < cams; ++i) {
+            cv::cvtColor(verifyTasks[i].frame, grayFrame, cv::COLOR_BGR2GRAY);
+            Utility::CharucoResults charucoResults{trackingDetectors_[i].findBoard(grayFrame, cornerThreshold)};
+            accepted[i] = charucoResults.boardFound;
+            allCharucoCorners_[i] = std::move(charucoResults.charucoCorners);
+            allCharucoIds_[i] = std::move(charucoResults.charucoIds);
+        }
+        if (std::ranges::find(accepted, true) == accepted.end()) return;
 
-                validatedCornersData.id = verifyTasks[i].id;
-                validatedCornersData.camId = i;
-                validatedCornersData.charucoIds = vec1;
-                validatedCornersData.charucoCorners = allCharucoCorners[i];
-                validatedCornersData.validatedImagePair = validatedImagePair;
-                validatedCornersData.validatedCorners = validatedCorners;
-                (void)valCornersQ_.enqueue(validatedCornersData);
+        // With a partial set there is no corner set common to all cameras, the count follows the best detection.
+        int setCorners{0};
+        for (auto i{0}; i < cams; ++i) {
+            if (!accepted[i]) continue;
+            ++acceptance_[i][i];
+            setCorners = std::max(setCorners, static_cast<int>(allCharucoIds_[i].size()));
+
+            for (auto j{i + 1}; j < cams; ++j) {
+                if (!accepted[j]) continue;
+
+                const auto overlap{
+                    static_cast<int>(Utility::intersection(allCharucoIds_[i], allCharucoIds_[j]).size())
+                };
+                if (overlap < cornerThreshold) continue;
+
+                ++acceptance_[i][j];
+                ++acceptance_[j][i];
+                acceptanceFile_ << verifyTasks[i].id << ',' << i << ',' << j << ',' << overlap << '\n';
+            }
+        }
+        (void)acceptanceFile_.flush();
+
+        validatedImagePair_ += 1;
+        validatedCorners_ += setCorners;
+
+        for (auto i{0}; i < cams; ++i) {
+            if (!accepted[i]) continue;
+
+            // Save image.
+            // TODO: Make path configurable.
+
+            std::filesystem::path imagePath = outputPath_ / ("images/raw/cam_" + std::to_string(i));
+            std::string imageName = "frame_" + std::to_string(verifyTasks[i].id) + ".png";
+            (void)std::filesystem::create_directories(imagePath);
+
+            cv::imwrite((imagePath / imageName).string(), verifyTasks[i].frame);
+
+            // Enqueue bounding box data for viewing.
+            ValidatedCornersData validatedCornersData;
+
+            validatedCornersData.id = verifyTasks[i].id;
+            validatedCornersData.camId = i;
+            validatedCornersData.charucoIds = allCharucoIds_[i];
+            validatedCornersData.charucoCorners = allCharucoCorners_[i];
+            validatedCornersData.validatedImagePair = validatedImagePair_;
+            validatedCornersData.validatedCorners = validatedCorners_;
+            validatedCornersData.acceptance = acceptance_;
+            if (estimatorQ_) {
+                (void)estimatorQ_->enqueue(validatedCornersData);
+            }
+            (void)valCornersQ_.enqueue(validatedCornersData);
+        }
+    }
+
+
+    void DetectionValidator::validateBestSet(const std::vector<std::vector<VerifyTask> >& sets,
+                                             const std::size_t count) {
+        const auto cams{camDatas_.size()};
+        std::vector<std::pair<std::size_t, double> > frameScores(count * cams);
+
+        cv::parallel_for_(cv::Range(0, static_cast<int>(count * cams)),
+                          [&](const cv::Range& range) {
+                              // The detector is not safe to share between threads, every stripe gets its own.
+                              const cv::aruco::CharucoDetector detector{
+                                  charucoDetector_.getBoard(),
+                                  charucoDetector_.getCharucoParameters(),
+                                  charucoDetector_.getDetectorParameters(),
+                                  charucoDetector_.getRefineParameters()
+                              };
+
+                              for (auto r{range.start}; r < range.end; ++r) {
+                                  const std::size_t set{static_cast<std::size_t>(r) / cams};
+                                  const std::size_t cam{static_cast<std::size_t>(r) % cams};
+                                  auto& [gray, small, laplacian]{scoreBuffers_[set][cam]};
+
+                                  cv::cvtColor(sets[set][cam].frame, gray, cv::COLOR_BGR2GRAY);
+                                  cv::resize(gray,
+                                             small,
+                                             {},
+                                             1. / GlobalVariables::burstScoreDownscale,
+                                             1. / GlobalVariables::burstScoreDownscale,
+                                             cv::INTER_AREA);
+
+                                  cv::Laplacian(small, laplacian, CV_32F);
+                                  cv::Scalar mean;
+                                  cv::Scalar stdDev;
+                                  cv::meanStdDev(laplacian, mean, stdDev);
+
+                                  frameScores[r] = {
+                                      Utility::findBoard(detector, small, 0).charucoCorners.size(),
+                                      stdDev[0] * stdDev[0]
+                                  };
+                              }
+                          });
+
+        // Cameras may miss the board in every frame of a burst, so the corners are summed over the cameras. The
+        // sharpness of the worst frame breaks ties.
+        std::size_t best{0};
+        std::pair<std::size_t, double> bestScore{};
+        for (std::size_t set{0}; set < count; ++set) {
+            std::pair score{std::size_t{0}, std::numeric_limits<double>::max()};
+            for (std::size_t cam{0}; cam < cams; ++cam) {
+                const auto& [corners, sharpness]{frameScores[set * cams + cam]};
+                score = {score.first + corners, std::min(score.second, sharpness)};
             }
+            if (set == 0 || score > bestScore) {
+                best = set;
+                bestScore = score;
+            }
+        }
+
+        validateSet(sets[best]);
+    }
+
+
+    void DetectionValidator::writeTrackingStatistics() const {
+        std::ofstream file(outputPath_ / GlobalVariables::trackingFileName, std::ios::trunc);
+        if (!file) return;
+
+        file << "camera,hits,misses,untracked\n";
+        for (std::size_t i{0}; i < trackingDetectors_.size(); ++i) {
+            const auto& [hits, misses, untracked]{trackingDetectors_[i].statistics()};
+            file << i << ',' << hits << ',' << misses << ',' << untracked << '\n';
         }
     }
 } // YACCP
@@ -4,6 +4,10 @@
 
 #include "recorders/camera_worker.hpp"
 
+#include "../detection/tracking_detector.hpp"
+
+#include <fstream>
+
 namespace YACCP {
     struct VerifyTask {
         int id;
@@ -17,13 +21,25 @@ namespace YACCP {
                            const cv::aruco::CharucoDetector& charucoDetector,
                            moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ,
                            const std::filesystem::path& outputPath,
-                           float cornerMin);
+                           float cornerMin,
+                           const Config::DetectionConfig& detectionConfig,
+                           int burstSize,
+                           moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>* estimatorQ = nullptr);
 
 
         void start();
 
 
     private:
+        /**
+         * @brief Scratch buffers to score a single frame, kept per burst slot and camera so they are reused.
+         */
+        struct ScoreBuffers {
+            cv::Mat gray;
+            cv::Mat small;
+            cv::Mat laplacian;
+        };
+
         std::stop_source stopSource_;
         std::stop_token stopToken_;
         std::vector<CamData>& camDatas_;
@@ -31,6 +47,47 @@ namespace YACCP {
         moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ_;
         const std::filesystem::path& outputPath_;
         float cornerMin_;
+        Config::DetectionConfig detectionConfig_;
+        int burstSize_;
+        // Optional queue feeding the CalibrationEstimator.
+        moodycamel::BlockingReaderWriterQueue<ValidatedCornersData>* estimatorQ_;
+
+        int validatedImagePair_{};
+        int validatedCorners_{};
+        std::vector<std::vector<cv::Point2f> > allCharucoCorners_;
+        std::vector<std::vector<int> > allCharucoIds_;
+        // Accepted views per camera on the diagonal and per camera pair off the diagonal.
+        std::vector<std::vector<int> > acceptance_;
+        std::ofstream acceptanceFile_;
+        std::vector<std::vector<ScoreBuffers> > scoreBuffers_;
+        // One per camera, successive sets of a camera show the board in about the same place.
+        std::vector<TrackingDetector> trackingDetectors_;
+
+        /**
+         * @brief Dequeue frames until every camera delivered the same task id.
+         *
+         * @return False when the stop was requested.
+         */
+        bool dequeueSet(std::vector<VerifyTask>& verifyTasks);
+
+        /**
+         * @brief Detect the board in a synchronised set and save and publish the frames that validate.
+         *
+         * Every camera is accepted on its own when it detects enough corners, its frame is then saved for the mono
+         * calibration. Every pair of accepted cameras that shares enough corners is recorded for the stereo
+         * calibration, so a board seen by only part of the rig still yields views.
+         */
+        void validateSet(const std::vector<VerifyTask>& verifyTasks);
+
+        /**
+         * @brief Validate the burst set with the highest score.
+         *
+         * Every frame is scored in parallel on the corners detected at a reduced resolution and the variance of its
+         * Laplacian, a set scores on the corners of all its frames and the sharpness of its worst frame.
+         */
+        void validateBestSet(const std::vector<std::vector<VerifyTask> >& sets, std::size_t count);
+
+        void writeTrackingStatistics() const;
     };
 } // YACCP
 
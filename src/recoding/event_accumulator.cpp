@@ -0,0 +1,346 @@
+#include "event_accumulator.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#if defined(YACCP_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define YACCP_ACCUMULATOR_AVX2
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define YACCP_TARGET_AVX2
+#else
+#define YACCP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#include <immintrin.h>
+#elif defined(YACCP_SIMD) && defined(__ARM_NEON)
+#define YACCP_ACCUMULATOR_NEON
+#include <arm_neon.h>
+#endif
+
+namespace YACCP {
+    namespace {
+        // The kernels read an event as four 32-bit words: x | y << 16, p, and the two halves of t.
+        static_assert(sizeof(Metavision::EventCD) == 16);
+        static_assert(offsetof(Metavision::EventCD, x) == 0 && offsetof(Metavision::EventCD, y) == 2 &&
+                      offsetof(Metavision::EventCD, p) == 4);
+
+        // Events decoded per call, small enough for the indices and weights to stay in L1.
+        constexpr std::size_t kernelBatch{256};
+
+        using DecodeKernel = void (*)(const Metavision::EventCD* events,
+                                      std::size_t n,
+                                      std::int32_t width,
+                                      std::int32_t* indices,
+                                      std::int32_t* weights);
+
+
+        // Pixel index of every event and its polarity as a weight of +1 or -1.
+        void decodeScalar(const Metavision::EventCD* events,
+                          const std::size_t n,
+                          const std::int32_t width,
+                          std::int32_t* indices,
+                          std::int32_t* weights) {
+            for (std::size_t i{0}; i < n; ++i) {
+                indices[i] = static_cast<std::int32_t>(events[i].y) * width + events[i].x;
+                weights[i] = 2 * static_cast<std::int32_t>(events[i].p) - 1;
+            }
+        }
+
+
+#if defined(YACCP_ACCUMULATOR_AVX2)
+        YACCP_TARGET_AVX2 void decodeAvx2(const Metavision::EventCD* events,
+                                          const std::size_t n,
+                                          const std::int32_t width,
+                                          std::int32_t* indices,
+                                          std::int32_t* weights) {
+            const __m256i lowMask{_mm256_set1_epi32(0xffff)};
+            const __m256i widths{_mm256_set1_epi32(width)};
+            const __m256i ones{_mm256_set1_epi32(1)};
+            const __m256i order{_mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)};
+
+            std::size_t i{0};
+            for (; i + 8 <= n; i += 8) {
+                // Every load holds two events, the shuffles gather the first two words of eight events.
+                const auto* words{reinterpret_cast<const float*>(events + i)};
+                const __m256 a{_mm256_loadu_ps(words)};
+                const __m256 b{_mm256_loadu_ps(words + 8)};
+                const __m256 c{_mm256_loadu_ps(words + 16)};
+                const __m256 d{_mm256_loadu_ps(words + 24)};
+                const __m256 ab{_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0))};
+                const __m256 cd{_mm256_shuffle_ps(c, d, _MM_SHUFFLE(1, 0, 1, 0))};
+                // The lanes hold the even and the odd events, the permutation restores the event order.
+                const __m256i xy{
+                    _mm256_permutevar8x32_epi32(_mm256_castps_si256(_mm256_shuffle_ps(ab, cd, _MM_SHUFFLE(2, 0, 2, 0))),
+                                                order)
+                };
+                const __m256i p{
+                    _mm256_permutevar8x32_epi32(_mm256_castps_si256(_mm256_shuffle_ps(ab, cd, _MM_SHUFFLE(3, 1, 3, 1))),
+                                                order)
+                };
+
+                const __m256i x{_mm256_and_si256(xy, lowMask)};
+                const __m256i y{_mm256_srli_epi32(xy, 16)};
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + i),
+                                    _mm256_add_epi32(_mm256_mullo_epi32(y, widths), x));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(weights + i),
+                                    _mm256_sub_epi32(_mm256_slli_epi32(_mm256_and_si256(p, lowMask), 1), ones));
+            }
+            decodeScalar(events + i, n - i, width, indices + i, weights + i);
+        }
+
+
+        bool hasAvx2() {
+#if defined(_MSC_VER)
+            std::array<int, 4> info{};
+            __cpuid(info.data(), 1);
+            // The CPU has to support AVX and the OS has to save the YMM registers as well.
+            const bool hasAvx{(info[2] & (1 << 28)) != 0};
+            const bool osSavesYmm{hasAvx && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6};
+            __cpuidex(info.data(), 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#elif defined(YACCP_ACCUMULATOR_NEON)
+        void decodeNeon(const Metavision::EventCD* events,
+                        const std::size_t n,
+                        const std::int32_t width,
+                        std::int32_t* indices,
+                        std::int32_t* weights) {
+            const uint32x4_t lowMask{vdupq_n_u32(0xffff)};
+            const uint32x4_t widths{vdupq_n_u32(static_cast<std::uint32_t>(width))};
+            const int32x4_t ones{vdupq_n_s32(1)};
+
+            std::size_t i{0};
+            for (; i + 4 <= n; i += 4) {
+                // De-interleaves four events into their x | y << 16, p and timestamp words.
+                const uint32x4x4_t words{vld4q_u32(reinterpret_cast<const std::uint32_t*>(events + i))};
+                const uint32x4_t x{vandq_u32(words.val[0], lowMask)};
+                const uint32x4_t y{vshrq_n_u32(words.val[0], 16)};
+                vst1q_s32(indices + i, vreinterpretq_s32_u32(vmlaq_u32(x, y, widths)));
+                const int32x4_t p{vreinterpretq_s32_u32(vandq_u32(words.val[1], lowMask))};
+                vst1q_s32(weights + i, vsubq_s32(vshlq_n_s32(p, 1), ones));
+            }
+            decodeScalar(events + i, n - i, width, indices + i, weights + i);
+        }
+#endif
+
+
+        DecodeKernel selectKernel() {
+#if defined(YACCP_ACCUMULATOR_AVX2)
+            if (hasAvx2()) return decodeAvx2;
+#elif defined(YACCP_ACCUMULATOR_NEON)
+            return decodeNeon;
+#endif
+            return decodeScalar;
+        }
+
+
+        const DecodeKernel decode{selectKernel()};
+
+
+        // Saturating event count per pixel.
+        void accumulateCounts(std::span<const Metavision::EventCD> events, cv::Mat& counts) {
+            auto* data{counts.ptr<std::uint16_t>()};
+            std::array<std::int32_t, kernelBatch> indices{};
+            std::array<std::int32_t, kernelBatch> weights{};
+            for (std::size_t begin{0}; begin < events.size(); begin += kernelBatch) {
+                const std::size_t n{std::min(kernelBatch, events.size() - begin)};
+                decode(events.data() + begin, n, counts.cols, indices.data(), weights.data());
+                for (std::size_t i{0}; i < n; ++i) {
+                    auto& count{data[indices[i]]};
+                    count += count != std::numeric_limits<std::uint16_t>::max();
+                }
+            }
+        }
+
+
+        // Saturating ON minus OFF events per pixel.
+        void accumulatePolarity(std::span<const Metavision::EventCD> events, cv::Mat& balance) {
+            auto* data{balance.ptr<std::int16_t>()};
+            std::array<std::int32_t, kernelBatch> indices{};
+            std::array<std::int32_t, kernelBatch> weights{};
+            for (std::size_t begin{0}; begin < events.size(); begin += kernelBatch) {
+                const std::size_t n{std::min(kernelBatch, events.size() - begin)};
+                decode(events.data() + begin, n, balance.cols, indices.data(), weights.data());
+                for (std::size_t i{0}; i < n; ++i) {
+                    auto& value{data[indices[i]]};
+                    value = cv::saturate_cast<std::int16_t>(value + weights[i]);
+                }
+            }
+        }
+
+
+        // Time of the last event per pixel relative to the trigger, events are in time order so the last write wins.
+        void accumulateTimes(std::span<const Metavision::EventCD> events,
+                             const Metavision::timestamp trigger,
+                             cv::Mat& times) {
+            auto* data{times.ptr<float>()};
+            std::array<std::int32_t, kernelBatch> indices{};
+            std::array<std::int32_t, kernelBatch> weights{};
+            for (std::size_t begin{0}; begin < events.size(); begin += kernelBatch) {
+                const std::size_t n{std::min(kernelBatch, events.size() - begin)};
+                decode(events.data() + begin, n, times.cols, indices.data(), weights.data());
+                for (std::size_t i{0}; i < n; ++i) {
+                    data[indices[i]] = static_cast<float>(events[begin + i].t - trigger);
+                }
+            }
+        }
+
+
+        // A board pixel fires on both transitions of every period in the window.
+        double blinkScale(const std::uint32_t accumulationTime, const Metavision::timestamp period) {
+            return GlobalVariables::eventCountScale /
+                   std::max(1., static_cast<double>(accumulationTime) / static_cast<double>(period));
+        }
+
+
+        // Phase within the blink period at which the most ON events arrive, the board-on transitions.
+        Metavision::timestamp findOnPhase(std::span<const Metavision::EventCD> events,
+                                          const Metavision::timestamp period,
+                                          std::vector<int>& histogram) {
+            const auto bins{static_cast<Metavision::timestamp>(histogram.size())};
+            std::ranges::fill(histogram, 0);
+            for (const auto& event : events) {
+                histogram[static_cast<std::size_t>(event.t % period * bins / period)] += event.p;
+            }
+            const auto peak{std::ranges::max_element(histogram) - histogram.begin()};
+            return (2 * peak + 1) * period / (2 * bins);
+        }
+
+
+        // ON minus OFF events within the gate around the on phase, OFF minus ON events within the gate half a period
+        // later. Every event outside both gates is counted as background.
+        void accumulateBlink(std::span<const Metavision::EventCD> events,
+                             const Metavision::timestamp period,
+                             const Metavision::timestamp onPhase,
+                             cv::Mat& signal,
+                             cv::Mat& background) {
+            const auto halfGate{
+                static_cast<Metavision::timestamp>(static_cast<double>(period) * GlobalVariables::blinkGateFraction / 2)
+            };
+            auto* signalData{signal.ptr<float>()};
+            auto* backgroundData{background.ptr<float>()};
+            std::array<std::int32_t, kernelBatch> indices{};
+            std::array<std::int32_t, kernelBatch> weights{};
+            for (std::size_t begin{0}; begin < events.size(); begin += kernelBatch) {
+                const std::size_t n{std::min(kernelBatch, events.size() - begin)};
+                decode(events.data() + begin, n, signal.cols, indices.data(), weights.data());
+                for (std::size_t i{0}; i < n; ++i) {
+                    const Metavision::timestamp phase{((events[begin + i].t - onPhase) % period + period) % period};
+                    if (phase < halfGate || phase >= period - halfGate) {
+                        signalData[indices[i]] += static_cast<float>(weights[i]);
+                    } else if (std::abs(phase - period / 2) < halfGate) {
+                        signalData[indices[i]] -= static_cast<float>(weights[i]);
+                    } else {
+                        backgroundData[indices[i]] += 1.F;
+                    }
+                }
+            }
+        }
+    }
+
+
+    EventAccumulator::EventAccumulator(const cv::Size resolution,
+                                       const Config::FrameRepresentation representation,
+                                       const std::uint32_t accumulationTime,
+                                       const int timeSurfaceDecay,
+                                       const double blinkFrequency) :
+        resolution_(resolution),
+        representation_(representation),
+        timeSurfaceDecay_(timeSurfaceDecay),
+        blinkPeriod_(std::max<Metavision::timestamp>(std::llround(1e6 / blinkFrequency), 2)),
+        blinkScale_(blinkScale(accumulationTime, blinkPeriod_)) {
+        switch (representation_) {
+        case Config::FrameRepresentation::metavision:
+            frameGenerator_ = std::make_unique<Metavision::OnDemandFrameGenerationAlgorithm>(
+                resolution_.width,
+                resolution_.height,
+                accumulationTime);
+            break;
+        case Config::FrameRepresentation::count:
+            counts_.create(resolution_, CV_16UC1);
+            break;
+        case Config::FrameRepresentation::polarity:
+            balance_.create(resolution_, CV_16SC1);
+            break;
+        case Config::FrameRepresentation::timeSurface:
+            times_.create(resolution_, CV_32FC1);
+            break;
+        case Config::FrameRepresentation::blink:
+            blinkSignal_.create(resolution_, CV_32FC1);
+            blinkBackground_.create(resolution_, CV_32FC1);
+            phaseHistogram_.resize(GlobalVariables::blinkPhaseBins);
+            break;
+        }
+    }
+
+
+    void EventAccumulator::render(std::span<const Metavision::EventCD> events,
+                                  const Metavision::timestamp trigger,
+                                  cv::Mat& frame) {
+        switch (representation_) {
+        case Config::FrameRepresentation::metavision: {
+            // The generator needs increasing timestamps, events it already received are not fed again.
+            const auto first{
+                std::ranges::lower_bound(events, lastFedTime_, {}, &Metavision::EventCD::t)
+            };
+            const auto* begin{events.data() + (first - events.begin())};
+            frameGenerator_->process_events(begin, events.data() + events.size());
+            lastFedTime_ = trigger;
+            frameGenerator_->generate(trigger, frame);
+            return;
+        }
+        case Config::FrameRepresentation::count:
+            counts_.setTo(0);
+            accumulateCounts(events, counts_);
+            counts_.convertTo(gray_, CV_8U, GlobalVariables::eventCountScale);
+            break;
+        case Config::FrameRepresentation::polarity:
+            balance_.setTo(0);
+            accumulatePolarity(events, balance_);
+            // Grey without events, brighter for ON and darker for OFF.
+            balance_.convertTo(gray_, CV_8U, GlobalVariables::eventPolarityScale, 128.);
+            break;
+        case Config::FrameRepresentation::timeSurface:
+            // Pixels without events decay to zero.
+            times_.setTo(-std::numeric_limits<float>::max());
+            accumulateTimes(events, trigger, times_);
+            times_ *= 1. / timeSurfaceDecay_;
+            cv::exp(times_, times_);
+            times_.convertTo(gray_, CV_8U, 255.);
+            break;
+        case Config::FrameRepresentation::blink: {
+            blinkSignal_.setTo(0);
+            blinkBackground_.setTo(0);
+            accumulateBlink(events,
+                            blinkPeriod_,
+                            findOnPhase(events, blinkPeriod_, phaseHistogram_),
+                            blinkSignal_,
+                            blinkBackground_);
+            // The background is spread over the phases outside both gates, scale it to the width of the gates.
+            const double gates{2 * GlobalVariables::blinkGateFraction};
+            cv::scaleAdd(blinkBackground_, -gates / (1. - gates), blinkSignal_, blinkSignal_);
+            // Negative values are background, convertTo saturates them to black.
+            blinkSignal_.convertTo(gray_, CV_8U, blinkScale_);
+            break;
+        }
+        }
+        cv::cvtColor(gray_, frame, cv::COLOR_GRAY2BGR);
+    }
+
+
+    void EventAccumulator::setAccumulationTime(const std::uint32_t accumulationTime) {
+        if (frameGenerator_) frameGenerator_->set_accumulation_time_us(accumulationTime);
+        blinkScale_ = blinkScale(accumulationTime, blinkPeriod_);
+    }
+} // YACCP
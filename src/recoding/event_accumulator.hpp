@@ -0,0 +1,76 @@
+#ifndef YACCP_SRC_RECORDING_EVENT_ACCUMULATOR_HPP
+#define YACCP_SRC_RECORDING_EVENT_ACCUMULATOR_HPP
+#include "../config/recording.hpp"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/core/algorithms/on_demand_frame_generation_algorithm.h>
+
+#include <opencv2/core/mat.hpp>
+
+namespace YACCP {
+    /**
+     * @brief Turns the CD events of a trigger window into a BGR frame with the configured representation.
+     *
+     * Count, polarity and time surface frames are accumulated with vectorised kernels, AVX2 is selected at runtime on
+     * x86-64 and NEON is used on ARM, both fall back to a scalar kernel. The Metavision representation keeps using
+     * OnDemandFrameGenerationAlgorithm, so recordings made before the kernels existed can be reproduced.
+     *
+     * The blink representation reconstructs the blinking board video. The phase of the board-on transitions is found
+     * from the ON events of the window, the ON events at that phase and the OFF events half a period later are
+     * accumulated while the events at every other phase are subtracted as background.
+     */
+    class EventAccumulator {
+    public:
+        /**
+         * @param resolution Resolution of the sensor.
+         * @param representation Representation of the rendered frames.
+         * @param accumulationTime Length of the window before the trigger in microseconds.
+         * @param timeSurfaceDecay Time constant of the time surface in microseconds.
+         * @param blinkFrequency Blink frequency of the board video in Hz, used by the blink representation.
+         */
+        EventAccumulator(cv::Size resolution,
+                         Config::FrameRepresentation representation,
+                         std::uint32_t accumulationTime,
+                         int timeSurfaceDecay,
+                         double blinkFrequency);
+
+        /**
+         * @brief Render the window ending at the trigger.
+         *
+         * @param events Events of [trigger - accumulationTime, trigger) in time order. Successive calls have to use
+         * increasing triggers.
+         * @param trigger Timestamp of the trigger.
+         * @param frame Rendered CV_8UC3 frame.
+         */
+        void render(std::span<const Metavision::EventCD> events, Metavision::timestamp trigger, cv::Mat& frame);
+
+        /**
+         * @brief Change the length of the window for the next render.
+         */
+        void setAccumulationTime(std::uint32_t accumulationTime);
+
+
+    private:
+        cv::Size resolution_;
+        Config::FrameRepresentation representation_;
+        int timeSurfaceDecay_;
+        Metavision::timestamp blinkPeriod_;
+        double blinkScale_;
+        std::unique_ptr<Metavision::OnDemandFrameGenerationAlgorithm> frameGenerator_;
+        Metavision::timestamp lastFedTime_{};
+
+        cv::Mat counts_;
+        cv::Mat balance_;
+        cv::Mat times_;
+        cv::Mat blinkSignal_;
+        cv::Mat blinkBackground_;
+        cv::Mat gray_;
+        std::vector<int> phaseHistogram_;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_EVENT_ACCUMULATOR_HPP
@@ -0,0 +1,95 @@
+#include "event_filter_chain.hpp"
+
+#include <fstream>
+#include <limits>
+
+namespace YACCP {
+    EventFilterChain::EventFilterChain(const cv::Size resolution,
+                                       const Config::Prophesee& config,
+                                       const bool keepBothPolarities) :
+        width_(resolution.width),
+        roiEnabled_(config.roi.has_value()),
+        polarity_(keepBothPolarities ? -1 : config.polarityFilter),
+        activityThreshold_(config.activityThreshold) {
+        if (config.roi) {
+            const auto& [x, y, width, height]{*config.roi};
+            roi_ = cv::Rect(x, y, width, height) & cv::Rect({}, resolution);
+        }
+
+        if (!config.hotPixels.empty()) {
+            hotMask_.assign(resolution.area(), 0);
+            for (const auto& [x, y] : config.hotPixels) {
+                if (x < 0 || y < 0 || x >= resolution.width || y >= resolution.height)
+                    throw std::runtime_error("Hot pixel (" + std::to_string(x) + ", " + std::to_string(y) +
+                                             ") lies outside of the sensor");
+                hotMask_[static_cast<std::size_t>(y) * width_ + x] = 1;
+            }
+        }
+
+        if (activityThreshold_ > 0) {
+            // A border of one pixel lets every event read its eight neighbours without bounds checks.
+            lastTimesStride_ = static_cast<std::size_t>(resolution.width) + 2;
+            lastTimes_.assign(lastTimesStride_ * (resolution.height + 2),
+                              std::numeric_limits<Metavision::timestamp>::min() / 2);
+        }
+    }
+
+
+    bool EventFilterChain::isSupported(const Metavision::EventCD& ev) {
+        const std::size_t centre{(static_cast<std::size_t>(ev.y) + 1) * lastTimesStride_ + ev.x + 1};
+        const Metavision::timestamp since{ev.t - activityThreshold_};
+        const auto* above{lastTimes_.data() + centre - lastTimesStride_ - 1};
+        const auto* row{lastTimes_.data() + centre - 1};
+        const auto* below{lastTimes_.data() + centre + lastTimesStride_ - 1};
+
+        const bool supported{
+            above[0] >= since || above[1] >= since || above[2] >= since ||
+            row[0] >= since || row[2] >= since ||
+            below[0] >= since || below[1] >= since || below[2] >= since
+        };
+        lastTimes_[centre] = ev.t;
+        return supported;
+    }
+
+
+    std::span<const Metavision::EventCD> EventFilterChain::process(const Metavision::EventCD* begin,
+                                                                   const Metavision::EventCD* end) {
+        const auto events{static_cast<std::size_t>(end - begin)};
+        if (!roiEnabled_ && polarity_ < 0 && hotMask_.empty() && activityThreshold_ <= 0) {
+            for (auto& count : counts_) count += events;
+            return {begin, end};
+        }
+
+        if (buffer_.size() < events) buffer_.resize(events);
+        auto* out{buffer_.data()};
+        std::array<std::uint64_t, stageCount> survived{};
+
+        for (auto ev = begin; ev != end; ++ev) {
+            if (roiEnabled_ && !roi_.contains({ev->x, ev->y})) continue;
+            ++survived[roi];
+            if (polarity_ >= 0 && ev->p != polarity_) continue;
+            ++survived[polarity];
+            if (!hotMask_.empty() && hotMask_[static_cast<std::size_t>(ev->y) * width_ + ev->x] != 0) continue;
+            ++survived[hotPixel];
+            if (activityThreshold_ > 0 && !isSupported(*ev)) continue;
+            ++survived[activity];
+            *out++ = *ev;
+        }
+
+        counts_[0] += events;
+        for (auto s{0}; s < stageCount; ++s) counts_[s + 1] += survived[s];
+        return {buffer_.data(), out};
+    }
+
+
+    void EventFilterChain::writeStats(const std::filesystem::path& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) throw std::runtime_error("Could not open " + path.string() + " for writing.");
+
+        constexpr std::array<const char*, stageCount> names{"roi", "polarity", "hot_pixel", "activity"};
+        file << "stage,events_in,events_out\n";
+        for (auto s{0}; s < stageCount; ++s) {
+            file << names[s] << ',' << counts_[s] << ',' << counts_[s + 1] << '\n';
+        }
+    }
+} // YACCP
@@ -0,0 +1,73 @@
+#ifndef YACCP_SRC_RECORDING_EVENT_FILTER_CHAIN_HPP
+#define YACCP_SRC_RECORDING_EVENT_FILTER_CHAIN_HPP
+#include "../config/recording.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+#include <opencv2/core/types.hpp>
+
+namespace YACCP {
+    /**
+     * @brief Software CD event filters fused into a single pass over every event buffer.
+     *
+     * The stages run in the order ROI crop, polarity, hot pixel mask and activity filter, cheapest first. The activity
+     * filter is a software alternative for sensors without the ETF facility, an event is kept when one of its eight
+     * neighbours fired within the threshold. The surviving events are written to a buffer that is reused between
+     * calls, so no allocations are made once it reached the largest buffer size.
+     */
+    class EventFilterChain {
+    public:
+        enum Stage {
+            roi,
+            polarity,
+            hotPixel,
+            activity,
+            stageCount
+        };
+
+        /**
+         * @param resolution Resolution of the sensor.
+         * @param config Filter configuration of the worker.
+         * @param keepBothPolarities Disable the polarity stage regardless of the configuration.
+         */
+        EventFilterChain(cv::Size resolution, const Config::Prophesee& config, bool keepBothPolarities);
+
+        /**
+         * @brief Filter a buffer of events.
+         *
+         * @return The surviving events, valid until the next call. The input itself when no stage is enabled.
+         */
+        [[nodiscard]] std::span<const Metavision::EventCD> process(const Metavision::EventCD* begin,
+                                                                   const Metavision::EventCD* end);
+
+        /**
+         * @brief Events that entered and left every stage so far, as a CSV file.
+         */
+        void writeStats(const std::filesystem::path& path) const;
+
+
+    private:
+        int width_;
+        bool roiEnabled_;
+        cv::Rect roi_;
+        int polarity_;
+        std::vector<std::uint8_t> hotMask_;
+        Metavision::timestamp activityThreshold_;
+        std::vector<Metavision::timestamp> lastTimes_;
+        std::size_t lastTimesStride_{};
+
+        std::vector<Metavision::EventCD> buffer_;
+        // Entry 0 counts the input, entry s + 1 the events that survived stage s.
+        std::array<std::uint64_t, stageCount + 1> counts_{};
+
+        [[nodiscard]] bool isSupported(const Metavision::EventCD& ev);
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_EVENT_FILTER_CHAIN_HPP
@@ -112,6 +112,7 @@ namespace YACCP {
     * @param m Mutex to protect access to the frame.
     * @param frameRequestQ Queue to request a new frame from the slave cameras.
     * @param frameVerifyQ Queue to send frames to the verification thread.
+    * @param eventRate Event rate of a Prophesee camera, read by the motion gate of the master camera.
     */
     struct CamData {
         // TODO: Remove this in favor of current config setup (horizontal views.)
@@ -120,6 +121,20 @@ namespace YACCP {
             int windowY;
         };
 
+        /**
+         * @brief Reprojection error statistics of a single view after calibration.
+         *
+         * @param rejected Whether the whole view was dropped by the outlier rejection.
+         */
+        struct ViewError {
+            std::string file;
+            double rms;
+            double maxError;
+            int corners;
+            int rejectedCorners;
+            bool rejected;
+        };
+
         struct CalibData {
             // Calibration results
             cv::Mat cameraMatrix;
@@ -127,6 +142,12 @@ namespace YACCP {
             std::vector<cv::Mat> rvecs;
             std::vector<cv::Mat> tvecs;
             double reprojError;
+            // Pose from the reference camera to this camera, only set by joint calibration.
+            cv::Mat rigRotation;
+            cv::Mat rigTranslation;
+            std::vector<ViewError> viewErrors;
+            // Bootstrap standard deviations of fx, fy, cx, cy and the distortion coefficients.
+            cv::Mat intrinsicStdDevs;
         };
 
         struct Info {
@@ -147,6 +168,8 @@ namespace YACCP {
             int exitCode;
             cv::Mat frame;
             std::mutex m;
+            // Filtered CD events per second, only set by Prophesee workers.
+            std::atomic<double> eventRate{0.};
 
             // Communication
             moodycamel::ReaderWriterQueue<int> frameRequestQ{100};
@@ -167,6 +190,16 @@ namespace YACCP {
         cv::Mat translationMatrix;
         cv::Mat essentialMatrix;
         cv::Mat fundamentalMatrix;
+        // Rectification from cv::stereoRectify, only set once the remap tables have been exported.
+        cv::Mat rectificationLeft;
+        cv::Mat rectificationRight;
+        cv::Mat projectionLeft;
+        cv::Mat projectionRight;
+        cv::Mat disparityToDepth;
+        // Bootstrap spread, the rotation spread is the RMS angle to the full solution in degrees.
+        cv::Mat translationStdDevs;
+        double baselineStdDev{};
+        double rotationStdDev{};
     };
 
 
@@ -184,6 +217,28 @@ namespace YACCP {
     }
 
 
+    inline void to_json(nlohmann::json& j, const CamData::ViewError& v) {
+        j = {
+            {"file", v.file},
+            {"rms", v.rms},
+            {"maxError", v.maxError},
+            {"corners", v.corners},
+            {"rejectedCorners", v.rejectedCorners},
+            {"rejected", v.rejected}
+        };
+    }
+
+
+    inline void from_json(const nlohmann::json& j, CamData::ViewError& v) {
+        j.at("file").get_to(v.file);
+        j.at("rms").get_to(v.rms);
+        j.at("maxError").get_to(v.maxError);
+        j.at("corners").get_to(v.corners);
+        j.at("rejectedCorners").get_to(v.rejectedCorners);
+        j.at("rejected").get_to(v.rejected);
+    }
+
+
     inline void to_json(nlohmann::json& j, const CamData::CalibData& c) {
         if (!c.cameraMatrix.empty()) {
             j = {
@@ -198,6 +253,14 @@ namespace YACCP {
                 j["rvecs"].push_back(vec3ToArray(c.rvecs[i]));
                 j["tvecs"].push_back(vec3ToArray(c.tvecs[i]));
             }
+
+            if (!c.rigRotation.empty()) {
+                j["rigRotation"] = matTo2dArray(c.rigRotation);
+                j["rigTranslation"] = matTo1dArray(c.rigTranslation);
+            }
+
+            if (!c.viewErrors.empty()) j["viewErrors"] = c.viewErrors;
+            if (!c.intrinsicStdDevs.empty()) j["intrinsicStdDevs"] = matTo1dArray(c.intrinsicStdDevs);
         }
     }
 
@@ -209,6 +272,13 @@ namespace YACCP {
 
         for (const auto& rv : j.at("rvecs")) c.rvecs.emplace_back(vec3FromArray(rv));
         for (const auto& tv : j.at("tvecs")) c.tvecs.emplace_back(vec3FromArray(tv));
+
+        if (j.contains("rigRotation")) {
+            c.rigRotation = matFrom2dArray(j.at("rigRotation"));
+            c.rigTranslation = matFrom1dArray(j.at("rigTranslation"));
+        }
+        if (j.contains("viewErrors")) j.at("viewErrors").get_to(c.viewErrors);
+        if (j.contains("intrinsicStdDevs")) c.intrinsicStdDevs = matFrom1dArray(j.at("intrinsicStdDevs"));
     }
 
 
@@ -261,6 +331,20 @@ namespace YACCP {
             {"essentialMatrix", matTo2dArray(s.essentialMatrix)},
             {"fundamentalMatrix", matTo2dArray(s.fundamentalMatrix)}
         };
+
+        if (!s.rectificationLeft.empty()) {
+            j["rectificationLeft"] = matTo2dArray(s.rectificationLeft);
+            j["rectificationRight"] = matTo2dArray(s.rectificationRight);
+            j["projectionLeft"] = matTo2dArray(s.projectionLeft);
+            j["projectionRight"] = matTo2dArray(s.projectionRight);
+            j["disparityToDepth"] = matTo2dArray(s.disparityToDepth);
+        }
+
+        if (!s.translationStdDevs.empty()) {
+            j["translationStdDevs"] = matTo1dArray(s.translationStdDevs);
+            j["baselineStdDev"] = s.baselineStdDev;
+            j["rotationStdDev"] = s.rotationStdDev;
+        }
     }
 
 
@@ -271,6 +355,19 @@ namespace YACCP {
         s.translationMatrix = matFrom1dArray(j.at("translationMatrix"));
         s.essentialMatrix = matFrom2dArray(j.at("essentialMatrix"));
         s.fundamentalMatrix = matFrom2dArray(j.at("fundamentalMatrix"));
+
+        if (j.contains("rectificationLeft")) {
+            s.rectificationLeft = matFrom2dArray(j.at("rectificationLeft"));
+            s.rectificationRight = matFrom2dArray(j.at("rectificationRight"));
+            s.projectionLeft = matFrom2dArray(j.at("projectionLeft"));
+            s.projectionRight = matFrom2dArray(j.at("projectionRight"));
+            s.disparityToDepth = matFrom2dArray(j.at("disparityToDepth"));
+        }
+        if (j.contains("translationStdDevs")) {
+            s.translationStdDevs = matFrom1dArray(j.at("translationStdDevs"));
+            j.at("baselineStdDev").get_to(s.baselineStdDev);
+            j.at("rotationStdDev").get_to(s.rotationStdDev);
+        }
     }
 }
 
@@ -2,6 +2,13 @@
 #include "basler_cam_worker.hpp"
 
 #include "../job_data.hpp"
+#include "motion_gate.hpp"
+#include "novelty_tracker.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+#include <optional>
 
 #include <tabulate/table.hpp>
 
@@ -99,9 +106,11 @@ namespace YACCP {
                                      Config::RecordingConfig& recordingConfig,
                                      const Config::Basler& configBackend,
                                      const int index,
-                                     const std::filesystem::path& jobPath) :
+                                     const std::filesystem::path& jobPath,
+                                     const cv::aruco::CharucoDetector& charucoDetector) :
         CameraWorker(stopSource, camDatas, recordingConfig, index, jobPath),
-        configBackend_(configBackend) {
+        configBackend_(configBackend),
+        charucoDetector_(charucoDetector) {
         Pylon::PylonInitialize();
         // TODO: Handle scenarios where the camera doesn't support external triggers
     }
@@ -197,13 +206,35 @@ namespace YACCP {
             camData_.runtimeData.isRunning.store(cam.IsGrabbing());
 
             if (camData_.info.isMaster) {
-                requestedFrame_ = 1 + recordingConfig_.fps * recordingConfig_.detectionInterval;
-                for (auto& [info, runtimeData] : camDatas_) {
-                    if (info.isMaster) {
-                        continue;
+                // A burst requests consecutive frames, the detection validator keeps the best synchronised set.
+                const auto requestFromSlaves{
+                    [this] {
+                        for (auto& [info, runtimeData] : camDatas_) {
+                            if (info.isMaster) {
+                                continue;
+                            }
+                            for (auto i{0}; i < recordingConfig_.burstSize; ++i) {
+                                (void)runtimeData.frameRequestQ.enqueue(requestedFrame_ + i);
+                            }
+                        }
                     }
-                    (void)runtimeData.frameRequestQ.enqueue(requestedFrame_);
-                }
+                };
+                int burstFrame{0};
+
+                // With the motion gate or novelty capture a request is only sent once the capture is due and the
+                // scene is still, otherwise the next request is sent ahead.
+                std::optional<MotionGate> motionGate;
+                if (recordingConfig_.motionGate) motionGate.emplace(recordingConfig_, camDatas_);
+                std::optional<NoveltyTracker> noveltyTracker;
+                if (recordingConfig_.noveltyCapture)
+                    noveltyTracker.emplace(recordingConfig_, camData_.info.resolution, charucoDetector_);
+                const bool requestAhead{!motionGate && !noveltyTracker};
+                bool requestSent{requestAhead};
+                bool captureDue{false};
+                int observedFrameIndex{0};
+
+                requestedFrame_ = 1 + recordingConfig_.fps * recordingConfig_.detectionInterval;
+                if (requestSent) requestFromSlaves();
 
                 while (cam.IsGrabbing() && !stopToken_.stop_requested()) {
                     cv::Mat localFrame;
@@ -222,20 +253,57 @@ namespace YACCP {
                         camData_.runtimeData.frame = localFrame.clone();
                     }
 
-                    if (localFrameIndex >= requestedFrame_) {
-                        VerifyTask frameData;
-                        frameData.id = requestedFrame_;
-                        frameData.frame = localFrame.clone();
-                        (void)camData_.runtimeData.frameVerifyQ.enqueue(frameData);
+                    if (!requestAhead && localFrameIndex != observedFrameIndex) {
+                        observedFrameIndex = localFrameIndex;
+                        if (motionGate) motionGate->observe(localFrame);
 
-                        requestedFrame_ = localFrameIndex + (recordingConfig_.fps * recordingConfig_.detectionInterval);
+                        if (!requestSent && !captureDue) {
+                            captureDue = noveltyTracker
+                                             ? localFrameIndex % GlobalVariables::noveltyFrameStride == 0 &&
+                                               noveltyTracker->observe(localFrame)
+                                             : localFrameIndex >= requestedFrame_;
+                        }
 
-                        for (auto& [info, runtimeData] : camDatas_) {
-                            if (info.isMaster) {
-                                continue;
-                            }
-                            (void)runtimeData.frameRequestQ.enqueue(requestedFrame_);
+                        // Request a frame shortly ahead once the capture is due and the gate opens.
+                        if (captureDue && (!motionGate || motionGate->open())) {
+                            requestedFrame_ = localFrameIndex + GlobalVariables::requestLeadFrames;
+                            if (noveltyTracker) noveltyTracker->accept();
+                            requestFromSlaves();
+                            requestSent = true;
+                            captureDue = false;
+                        }
+                    }
+
+                    if (requestSent && localFrameIndex >= requestedFrame_ + burstFrame) {
+                        // Only the frame with the requested index is synchronised with the slaves. Indices a lagging
+                        // loop skipped are sent without a frame, so the validator discards their sets.
+                        const int burstEnd{requestedFrame_ + recordingConfig_.burstSize};
+                        while (requestedFrame_ + burstFrame < std::min(localFrameIndex, burstEnd)) {
+                            (void)camData_.runtimeData.frameVerifyQ.enqueue({requestedFrame_ + burstFrame++, {}});
                         }
+                        if (localFrameIndex < burstEnd) {
+                            VerifyTask frameData;
+                            frameData.id = localFrameIndex;
+                            // The local frame is already a private copy, hand it over instead of copying it again.
+                            frameData.frame = std::move(localFrame);
+                            (void)camData_.runtimeData.frameVerifyQ.enqueue(frameData);
+                            ++burstFrame;
+                        }
+                        if (burstFrame < recordingConfig_.burstSize) continue;
+                        burstFrame = 0;
+
+                        requestedFrame_ = localFrameIndex + (recordingConfig_.fps * recordingConfig_.detectionInterval);
+                        requestSent = requestAhead;
+                        if (requestSent) requestFromSlaves();
+                    }
+                }
+
+                if (motionGate) {
+                    try {
+                        motionGate->writeHistogram(jobPath_ / GlobalVariables::motionGateLogFileName);
+                    }
+                    catch (const std::exception& e) {
+                        std::cerr << e.what() << "\n";
                     }
                 }
             } else {
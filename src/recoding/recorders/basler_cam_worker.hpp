@@ -2,6 +2,8 @@
 #define YACCP_SRC_RECORDING_RECORDERS_BASLER_CAM_WORKER_HPP
 #include "camera_worker.hpp"
 
+#include <opencv2/objdetect/charuco_detector.hpp>
+
 #include <pylon/PylonIncludes.h>
 
 
@@ -16,7 +18,8 @@ namespace YACCP {
                         Config::RecordingConfig& recordingConfig,
                         const Config::Basler& configBackend,
                         int index,
-                        const std::filesystem::path& jobPath);
+                        const std::filesystem::path& jobPath,
+                        const cv::aruco::CharucoDetector& charucoDetector);
 
         static void listAvailableSources();
 
@@ -27,6 +30,8 @@ namespace YACCP {
 
     private:
         const Config::Basler& configBackend_;
+        // Preview detections of the novelty capture.
+        const cv::aruco::CharucoDetector& charucoDetector_;
         int requestedFrame_{1};    // Start from frame 1
 
         void setPixelFormat(GenApi::INodeMap& nodeMap);
@@ -0,0 +1,135 @@
+#include "event_rate_governor.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+
+namespace YACCP {
+    EventRateGovernor::EventRateGovernor(const std::chrono::milliseconds maxLag,
+                                         Metavision::I_ErcModule* erc,
+                                         const std::optional<std::uint32_t> ercMaxRate,
+                                         const std::filesystem::path& logPath) :
+        maxLag_(maxLag),
+        erc_(erc),
+        log_(logPath, std::ios::trunc) {
+        if (erc_ != nullptr) {
+            ercMaxRate_ = ercMaxRate.value_or(erc_->get_cd_event_rate());
+            ercRate_ = ercMaxRate_;
+        }
+        log_ << "wall_ms,event_us,rate_ev_s,lag_ms,load,action,erc_rate,decimation\n";
+    }
+
+
+    void EventRateGovernor::update(const Metavision::timestamp lastEventTime,
+                                   const std::size_t events,
+                                   const std::chrono::steady_clock::duration processing) {
+        const auto now{std::chrono::steady_clock::now()};
+        if (!wallStart_) {
+            wallStart_ = now;
+            eventStart_ = lastEventTime;
+            intervalStart_ = now;
+            intervalEventStart_ = lastEventTime;
+        }
+
+        // Events are buffered before they reach the callback, only the growth of the clock offset is lag.
+        const auto offset{
+            std::chrono::duration_cast<std::chrono::microseconds>(now - *wallStart_) -
+            std::chrono::microseconds(lastEventTime - eventStart_)
+        };
+        minOffset_ = std::min(minOffset_, offset);
+
+        intervalEvents_ += events;
+        intervalProcessing_ += processing;
+        if (now - intervalStart_ < GlobalVariables::governorInterval) return;
+
+        const auto eventSpan{std::max<Metavision::timestamp>(lastEventTime - intervalEventStart_, 1)};
+        const double rate{static_cast<double>(intervalEvents_) * 1e6 / static_cast<double>(eventSpan)};
+        // Fraction of the event time the callbacks spent processing.
+        const double load{
+            static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(intervalProcessing_).count()) /
+            static_cast<double>(eventSpan)
+        };
+        adjust(lastEventTime, rate, offset - minOffset_, load);
+
+        intervalStart_ = now;
+        intervalEventStart_ = lastEventTime;
+        intervalEvents_ = 0;
+        intervalProcessing_ = {};
+    }
+
+
+    int EventRateGovernor::decimation() const {
+        return decimation_;
+    }
+
+
+    void EventRateGovernor::adjust(const Metavision::timestamp lastEventTime,
+                                   const double rate,
+                                   const std::chrono::microseconds lag,
+                                   const double load) {
+        if (lag > maxLag_) {
+            // Bring the controller below the measured rate, the backlog is only worked off below it.
+            if (erc_ != nullptr) {
+                const auto minRate{
+                    static_cast<std::uint32_t>(ercMaxRate_ * GlobalVariables::governorMinErcFraction)
+                };
+                const auto target{
+                    std::clamp(static_cast<std::uint32_t>(rate * GlobalVariables::governorThrottleFactor),
+                               minRate,
+                               ercRate_)
+                };
+                if (target < ercRate_ && erc_->set_cd_event_rate(target)) {
+                    ercRate_ = target;
+                    logAdjustment(lastEventTime, rate, lag, load, "erc_down");
+                    return;
+                }
+            }
+            if (decimationIneffective_) return;
+
+            // Decimation only thins the preview, when the lag comes from the trigger path it does not drop. This also
+            // catches the maximum decimation no longer helping.
+            if (decimation_ > 1 && lag >= decimationLag_) {
+                decimation_ /= 2;
+                decimationIneffective_ = true;
+                logAdjustment(lastEventTime, rate, lag, load, "decimate_ineffective");
+                return;
+            }
+            if (decimation_ < GlobalVariables::governorMaxDecimation) {
+                decimation_ *= 2;
+                decimationLag_ = lag;
+                logAdjustment(lastEventTime, rate, lag, load, "decimate_up");
+            }
+            return;
+        }
+        decimationIneffective_ = false;
+
+        // Only relax once the backlog is gone and the callbacks have headroom.
+        if (lag > maxLag_ / 4 || load > GlobalVariables::governorRelaxLoad) return;
+
+        if (decimation_ > 1) {
+            decimation_ /= 2;
+            logAdjustment(lastEventTime, rate, lag, load, "decimate_down");
+        } else if (erc_ != nullptr && ercRate_ < ercMaxRate_) {
+            const auto target{
+                std::min(ercMaxRate_, static_cast<std::uint32_t>(ercRate_ / GlobalVariables::governorThrottleFactor))
+            };
+            if (erc_->set_cd_event_rate(target)) {
+                ercRate_ = target;
+                logAdjustment(lastEventTime, rate, lag, load, "erc_up");
+            }
+        }
+    }
+
+
+    void EventRateGovernor::logAdjustment(const Metavision::timestamp lastEventTime,
+                                          const double rate,
+                                          const std::chrono::microseconds lag,
+                                          const double load,
+                                          const char* action) {
+        const auto wall{std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+            *wallStart_)};
+        log_ << wall.count() << ',' << lastEventTime << ',' << static_cast<std::uint64_t>(rate) << ',' <<
+            static_cast<double>(lag.count()) / 1e3 << ',' << load << ',' << action << ',' << ercRate_ <<
+            ',' << decimation_ << std::endl;
+    }
+} // YACCP
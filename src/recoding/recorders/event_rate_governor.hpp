@@ -0,0 +1,86 @@
+#ifndef YACCP_SRC_RECORDING_RECORDERS_EVENT_RATE_GOVERNOR_HPP
+#define YACCP_SRC_RECORDING_RECORDERS_EVENT_RATE_GOVERNOR_HPP
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+#include <metavision/hal/facilities/i_erc_module.h>
+#include <metavision/sdk/base/utils/timestamp.h>
+
+namespace YACCP {
+    /**
+     * @brief Closed-loop controller that keeps the CD callback chain of a Prophesee worker real-time.
+     *
+     * The lag is the growth of the difference between the wall clock and the event clock, it increases while the
+     * callbacks process events slower than the sensor produces them. Above the maximum lag the governor lowers the
+     * hardware event rate controller, when the user enabled it, and otherwise decimates the events of the preview. The
+     * trigger frame path always receives every event the sensor delivers, so decimation only helps when the preview is
+     * the bottleneck. It is only raised further while the lag drops after every step, a step without effect is undone
+     * and no further steps are taken until the lag is gone. Once the lag is gone the throttling is relaxed again step
+     * by step. Every adjustment is appended to a CSV log.
+     */
+    class EventRateGovernor {
+    public:
+        /**
+         * @param maxLag Lag above which the governor throttles.
+         * @param erc Event rate controller to adjust, nullptr to only decimate the preview.
+         * @param ercMaxRate Configured rate of the controller in events per second, the governor never exceeds it.
+         * @param logPath CSV file the adjustments are written to.
+         */
+        EventRateGovernor(std::chrono::milliseconds maxLag,
+                          Metavision::I_ErcModule* erc,
+                          std::optional<std::uint32_t> ercMaxRate,
+                          const std::filesystem::path& logPath);
+
+        /**
+         * @brief Register a processed batch of CD events, called at the end of every CD callback.
+         *
+         * @param lastEventTime Timestamp of the last event in the batch.
+         * @param events Amount of events in the batch.
+         * @param processing Wall time the callback spent on the batch.
+         */
+        void update(Metavision::timestamp lastEventTime,
+                    std::size_t events,
+                    std::chrono::steady_clock::duration processing);
+
+        /**
+         * @brief The preview keeps every n-th event, 1 keeps all events.
+         */
+        [[nodiscard]] int decimation() const;
+
+
+    private:
+        const std::chrono::microseconds maxLag_;
+        Metavision::I_ErcModule* erc_;
+        std::uint32_t ercMaxRate_{};
+        std::uint32_t ercRate_{};
+        int decimation_{1};
+        // Lag at the last decimation step, and whether decimation was found not to reduce the lag.
+        std::chrono::microseconds decimationLag_{};
+        bool decimationIneffective_{false};
+        std::ofstream log_;
+
+        // Anchors of the clocks, the smallest offset seen is the offset without lag.
+        std::optional<std::chrono::steady_clock::time_point> wallStart_;
+        Metavision::timestamp eventStart_{};
+        std::chrono::microseconds minOffset_{std::chrono::microseconds::max()};
+
+        // Statistics of the current control interval.
+        std::chrono::steady_clock::time_point intervalStart_;
+        Metavision::timestamp intervalEventStart_{};
+        std::uint64_t intervalEvents_{};
+        std::chrono::steady_clock::duration intervalProcessing_{};
+
+        void adjust(Metavision::timestamp lastEventTime, double rate, std::chrono::microseconds lag, double load);
+
+        void logAdjustment(Metavision::timestamp lastEventTime,
+                           double rate,
+                           std::chrono::microseconds lag,
+                           double load,
+                           const char* action);
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_RECORDERS_EVENT_RATE_GOVERNOR_HPP
@@ -0,0 +1,58 @@
+#include "event_ring.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+
+namespace YACCP {
+    static bool isBefore(const Metavision::EventCD& ev, const Metavision::timestamp t) {
+        return ev.t < t;
+    }
+
+
+    EventRing::EventRing(const Metavision::timestamp span) : span_(span) {
+    }
+
+
+    void EventRing::push(const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        if (begin == end) return;
+        events_.insert(events_.end(), begin, end);
+
+        const Metavision::timestamp retained{
+            std::max(retain_, newest() - static_cast<Metavision::timestamp>(GlobalVariables::eventRingMaxRetain))
+        };
+        const auto first{
+            std::lower_bound(events_.begin() + static_cast<std::ptrdiff_t>(head_),
+                             events_.end(),
+                             std::min(newest() - span_, retained),
+                             isBefore)
+        };
+        head_ = static_cast<std::size_t>(first - events_.begin());
+
+        if (head_ * 2 > events_.size()) {
+            (void)events_.erase(events_.begin(), first);
+            head_ = 0;
+        }
+    }
+
+
+    Metavision::timestamp EventRing::newest() const {
+        return head_ < events_.size() ? events_.back().t : -1;
+    }
+
+
+    void EventRing::retainFrom(const Metavision::timestamp from) {
+        retain_ = from;
+    }
+
+
+    std::span<const Metavision::EventCD> EventRing::window(const Metavision::timestamp from,
+                                                           const Metavision::timestamp to) const {
+        const auto begin{std::lower_bound(events_.begin() + static_cast<std::ptrdiff_t>(head_),
+                                          events_.end(),
+                                          from,
+                                          isBefore)};
+        const auto end{std::lower_bound(begin, events_.end(), to, isBefore)};
+        return {begin, end};
+    }
+} // YACCP
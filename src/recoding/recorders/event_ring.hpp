@@ -0,0 +1,56 @@
+#ifndef YACCP_SRC_RECORDING_RECORDERS_EVENT_RING_HPP
+#define YACCP_SRC_RECORDING_RECORDERS_EVENT_RING_HPP
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <metavision/sdk/base/events/event_cd.h>
+
+namespace YACCP {
+    /**
+     * @brief Time-bounded buffer of the most recent CD events.
+     *
+     * Only events within span of the newest event are kept, unless they are retained for a trigger that may still be
+     * requested. Evicted events are compacted away once they make up half of the buffer, so pushing is amortised
+     * constant time per event.
+     */
+    class EventRing {
+    public:
+        explicit EventRing(Metavision::timestamp span);
+
+        /**
+         * @param begin First event, events have to arrive in time order.
+         * @param end One past the last event.
+         */
+        void push(const Metavision::EventCD* begin, const Metavision::EventCD* end);
+
+        /**
+         * @brief Timestamp of the newest event, -1 while the ring is empty.
+         */
+        [[nodiscard]] Metavision::timestamp newest() const;
+
+        /**
+         * @brief Keep the events from the given timestamp on even when they are older than span.
+         *
+         * CD buffers can be delivered before the trigger that lies inside them, retaining from the window of the last
+         * trigger keeps the window of the next one. At most GlobalVariables::eventRingMaxRetain before the newest event
+         * is retained, so the buffer stays bounded when the triggers stop.
+         */
+        void retainFrom(Metavision::timestamp from);
+
+        /**
+         * @brief The buffered events in [from, to), valid until the next push.
+         */
+        [[nodiscard]] std::span<const Metavision::EventCD> window(Metavision::timestamp from,
+                                                                  Metavision::timestamp to) const;
+
+
+    private:
+        Metavision::timestamp span_;
+        std::vector<Metavision::EventCD> events_;
+        std::size_t head_{};
+        Metavision::timestamp retain_{std::numeric_limits<Metavision::timestamp>::max()};
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_RECORDERS_EVENT_RING_HPP
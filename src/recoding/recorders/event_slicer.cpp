@@ -0,0 +1,129 @@
+#include "event_slicer.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+#include "../../utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    namespace {
+        // Detected corners first, the variance of the Laplacian breaks ties and ranks frames without a detector.
+        std::pair<std::size_t, double> scoreFrame(const cv::Mat& frame,
+                                                  const cv::aruco::CharucoDetector* charucoDetector) {
+            cv::Mat gray;
+            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+            cv::Mat laplacian;
+            cv::Laplacian(gray, laplacian, CV_32F);
+            cv::Scalar mean;
+            cv::Scalar stdDev;
+            cv::meanStdDev(laplacian, mean, stdDev);
+
+            const std::size_t corners{
+                charucoDetector != nullptr ? Utility::findBoard(*charucoDetector, gray, 0).charucoCorners.size() : 0
+            };
+            return {corners, stdDev[0] * stdDev[0]};
+        }
+    }
+
+
+    EventSlicer::EventSlicer(const cv::Size resolution,
+                             const Config::Prophesee& config,
+                             const std::uint32_t accumulationTime,
+                             const cv::aruco::CharucoDetector* charucoDetector) :
+        slicing_(config.frameSlicing),
+        accumulationTime_(accumulationTime),
+        eventCount_(static_cast<std::size_t>(config.sliceEventCount)),
+        charucoDetector_(charucoDetector) {
+        if (slicing_ == Config::FrameSlicing::best) {
+            // From accumulationTime / sliceWindowFactor to accumulationTime * sliceWindowFactor.
+            const int candidates{config.sliceCandidates};
+            for (auto i{0}; i < candidates; ++i) {
+                const double exponent{2. * i / (candidates - 1) - 1.};
+                windows_.emplace_back(static_cast<std::uint32_t>(
+                    std::lround(accumulationTime * std::pow(GlobalVariables::sliceWindowFactor, exponent))));
+            }
+        } else {
+            windows_.emplace_back(accumulationTime);
+        }
+
+        // Every window has its own accumulator, the Metavision generator keeps state between renders.
+        for (const auto window : windows_) {
+            accumulators_.emplace_back(resolution,
+                                       config.frameRepresentation,
+                                       window,
+                                       config.timeSurfaceDecay,
+                                       config.blinkFrequency);
+        }
+    }
+
+
+    std::uint32_t EventSlicer::maxWindow() const {
+        if (slicing_ == Config::FrameSlicing::eventCount) return accumulationTime_ * GlobalVariables::sliceWindowFactor;
+        return std::ranges::max(windows_);
+    }
+
+
+    void EventSlicer::render(const EventRing& eventRing,
+                             const Metavision::timestamp trigger,
+                             std::vector<cv::Mat>& candidates) {
+        candidates.resize(windows_.size());
+        switch (slicing_) {
+        case Config::FrameSlicing::fixed:
+            accumulators_.front().render(eventRing.window(trigger - accumulationTime_, trigger),
+                                         trigger,
+                                         candidates.front());
+            return;
+        case Config::FrameSlicing::eventCount: {
+            const auto events{eventRing.window(trigger - maxWindow(), trigger)};
+            std::uint32_t window{maxWindow()};
+            if (events.size() > eventCount_) {
+                window = std::max(static_cast<std::uint32_t>(trigger - events[events.size() - eventCount_].t),
+                                  accumulationTime_ / GlobalVariables::sliceWindowFactor);
+            }
+            accumulators_.front().setAccumulationTime(window);
+            accumulators_.front().render(eventRing.window(trigger - window, trigger), trigger, candidates.front());
+            return;
+        }
+        case Config::FrameSlicing::best:
+            cv::parallel_for_(cv::Range(0, static_cast<int>(windows_.size())),
+                              [&](const cv::Range& range) {
+                                  for (auto i{range.start}; i < range.end; ++i) {
+                                      accumulators_[i].render(eventRing.window(trigger - windows_[i], trigger),
+                                                              trigger,
+                                                              candidates[i]);
+                                  }
+                              });
+            return;
+        }
+    }
+
+
+    std::size_t EventSlicer::select(const std::vector<cv::Mat>& candidates) const {
+        if (candidates.size() < 2) return 0;
+
+        std::vector<std::pair<std::size_t, double> > scores(candidates.size());
+        cv::parallel_for_(cv::Range(0, static_cast<int>(candidates.size())),
+                          [&](const cv::Range& range) {
+                              // The detector is not safe to share between threads, every stripe gets its own.
+                              std::optional<cv::aruco::CharucoDetector> detector;
+                              if (charucoDetector_ != nullptr) {
+                                  detector.emplace(charucoDetector_->getBoard(),
+                                                   charucoDetector_->getCharucoParameters(),
+                                                   charucoDetector_->getDetectorParameters(),
+                                                   charucoDetector_->getRefineParameters());
+                              }
+
+                              for (auto i{range.start}; i < range.end; ++i) {
+                                  scores[i] = scoreFrame(candidates[i], detector ? &*detector : nullptr);
+                              }
+                          });
+        return static_cast<std::size_t>(std::ranges::max_element(scores) - scores.begin());
+    }
+} // YACCP
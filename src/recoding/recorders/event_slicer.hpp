@@ -0,0 +1,65 @@
+#ifndef YACCP_SRC_RECORDING_RECORDERS_EVENT_SLICER_HPP
+#define YACCP_SRC_RECORDING_RECORDERS_EVENT_SLICER_HPP
+#include "../event_accumulator.hpp"
+#include "event_ring.hpp"
+
+#include "../../config/recording.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/objdetect/charuco_detector.hpp>
+
+namespace YACCP {
+    /**
+     * @brief Chooses the event window a trigger frame is rendered from.
+     *
+     * Event count slicing starts the window at the event that makes it hold the target amount of events, so a slowly
+     * moving board still gives a dense frame and a fast one a short, sharp frame. Best slicing renders geometrically
+     * spaced candidate windows in parallel from the same events and keeps the frame with the most detected corners,
+     * the variance of the Laplacian breaks ties. Both are bounded to sliceWindowFactor around the fixed window.
+     *
+     * Rendering needs the event ring and runs on the decoding thread, selecting runs the board detection and belongs
+     * on another thread so the decoding does not stall.
+     */
+    class EventSlicer {
+    public:
+        /**
+         * @param resolution Resolution of the sensor.
+         * @param config Representation and slicing configuration of the worker.
+         * @param accumulationTime Fixed window in microseconds.
+         * @param charucoDetector Detector used to score the candidates, nullptr scores on sharpness alone.
+         */
+        EventSlicer(cv::Size resolution,
+                    const Config::Prophesee& config,
+                    std::uint32_t accumulationTime,
+                    const cv::aruco::CharucoDetector* charucoDetector);
+
+        /**
+         * @brief Longest window that can be used, the event ring has to hold at least this span.
+         */
+        [[nodiscard]] std::uint32_t maxWindow() const;
+
+        /**
+         * @brief Render the candidate frames of a trigger from the ring, a single one unless best slicing is used.
+         */
+        void render(const EventRing& eventRing, Metavision::timestamp trigger, std::vector<cv::Mat>& candidates);
+
+        /**
+         * @brief Index of the candidate to keep, safe to call from another thread than render.
+         */
+        [[nodiscard]] std::size_t select(const std::vector<cv::Mat>& candidates) const;
+
+
+    private:
+        Config::FrameSlicing slicing_;
+        std::uint32_t accumulationTime_;
+        std::size_t eventCount_;
+        const cv::aruco::CharucoDetector* charucoDetector_;
+
+        std::vector<std::uint32_t> windows_;
+        std::vector<EventAccumulator> accumulators_;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_RECORDERS_EVENT_SLICER_HPP
@@ -0,0 +1,88 @@
+#include "motion_gate.hpp"
+
+#include "../job_data.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    MotionGate::MotionGate(const Config::RecordingConfig& config, std::vector<CamData>& camDatas) :
+        camDatas_(camDatas),
+        maxEventRate_(config.gateEventRate),
+        maxFrameDifference_(config.gateFrameDifference),
+        timeout_(config.gateTimeout),
+        // One bin per histogram step up to the timeout, the deferrals that reached it are counted separately.
+        histogram_(static_cast<std::size_t>(timeout_ / GlobalVariables::motionGateHistogramStep) + 1) {
+    }
+
+
+    void MotionGate::observe(const cv::Mat& frame) {
+        if (!maxFrameDifference_) return;
+
+        // The difference is taken on a downscaled grey frame, sensor noise averages out and it stays cheap.
+        cv::Mat gray;
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        cv::resize(gray,
+                   current_,
+                   {},
+                   1. / GlobalVariables::motionGateDownscale,
+                   1. / GlobalVariables::motionGateDownscale,
+                   cv::INTER_AREA);
+
+        if (previous_.size() == current_.size()) {
+            cv::absdiff(current_, previous_, gray);
+            frameDifference_ = cv::mean(gray)[0];
+        }
+        std::swap(previous_, current_);
+    }
+
+
+    bool MotionGate::open() {
+        const auto now{std::chrono::steady_clock::now()};
+        if (!deferring_) {
+            deferring_ = true;
+            deferralStart_ = now;
+        }
+
+        const bool still{
+            (!maxEventRate_ || maxEventRate() < *maxEventRate_) &&
+            (!maxFrameDifference_ || frameDifference_ < *maxFrameDifference_)
+        };
+        const auto deferral{std::chrono::duration_cast<std::chrono::milliseconds>(now - deferralStart_)};
+        if (!still && deferral < timeout_) return false;
+
+        if (still) {
+            ++histogram_[std::min(static_cast<std::size_t>(deferral / GlobalVariables::motionGateHistogramStep),
+                                  histogram_.size() - 1)];
+        } else {
+            ++timeouts_;
+        }
+        deferring_ = false;
+        return true;
+    }
+
+
+    void MotionGate::writeHistogram(const std::filesystem::path& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) throw std::runtime_error("Could not open " + path.string() + " for writing.");
+
+        file << "deferral_ms,captures\n";
+        for (std::size_t i{0}; i < histogram_.size(); ++i) {
+            file << i * GlobalVariables::motionGateHistogramStep.count() << ',' << histogram_[i] << '\n';
+        }
+        file << "timeout," << timeouts_ << '\n';
+    }
+
+
+    double MotionGate::maxEventRate() const {
+        double rate{0};
+        for (const auto& camData : camDatas_) {
+            rate = std::max(rate, camData.runtimeData.eventRate.load());
+        }
+        return rate;
+    }
+} // YACCP
@@ -0,0 +1,63 @@
+#ifndef YACCP_SRC_RECORDING_RECORDERS_MOTION_GATE_HPP
+#define YACCP_SRC_RECORDING_RECORDERS_MOTION_GATE_HPP
+#include "../../config/recording.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <opencv2/core/mat.hpp>
+
+namespace YACCP {
+    struct CamData;
+
+    /**
+     * @brief Defers a due frame request of the master camera until the scene is still.
+     *
+     * Motion is measured as the event rate of the Prophesee workers, after their software filters so a configured ROI
+     * limits it to the board, and as the mean absolute difference between successive master frames. The gate opens
+     * once every configured measure is below its threshold or the deferral reached the timeout. The deferral of every
+     * capture is kept in a histogram.
+     */
+    class MotionGate {
+    public:
+        MotionGate(const Config::RecordingConfig& config, std::vector<CamData>& camDatas);
+
+        /**
+         * @brief Register a new frame of the master camera, called once for every frame.
+         */
+        void observe(const cv::Mat& frame);
+
+        /**
+         * @brief Whether the due capture may be requested, the deferral starts at the first call.
+         */
+        [[nodiscard]] bool open();
+
+        /**
+         * @brief Deferral histogram of the session as a CSV file.
+         */
+        void writeHistogram(const std::filesystem::path& path) const;
+
+
+    private:
+        std::vector<CamData>& camDatas_;
+        std::optional<double> maxEventRate_;
+        std::optional<double> maxFrameDifference_;
+        std::chrono::milliseconds timeout_;
+
+        cv::Mat previous_;
+        cv::Mat current_;
+        double frameDifference_{};
+
+        bool deferring_{false};
+        std::chrono::steady_clock::time_point deferralStart_;
+        std::vector<std::uint64_t> histogram_;
+        std::uint64_t timeouts_{};
+
+        [[nodiscard]] double maxEventRate() const;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_RECORDERS_MOTION_GATE_HPP
@@ -0,0 +1,83 @@
+#include "novelty_tracker.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+#include "../../utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+namespace YACCP {
+    NoveltyTracker::NoveltyTracker(const Config::RecordingConfig& config,
+                                   const cv::Size resolution,
+                                   const cv::aruco::CharucoDetector& charucoDetector) :
+        charucoDetector_(charucoDetector),
+        minCoverage_(config.noveltyCoverage),
+        minDisplacement_(config.noveltyDisplacement),
+        minSpacing_(config.noveltyMinSpacing),
+        diagonal_(std::hypot(resolution.width, resolution.height)),
+        coverage_(resolution, GlobalVariables::noveltyCellSize) {
+    }
+
+
+    bool NoveltyTracker::observe(const cv::Mat& frame) {
+        ids_.clear();
+        corners_.clear();
+        if (lastCapture_ && std::chrono::steady_clock::now() - *lastCapture_ < minSpacing_) return false;
+
+        cv::cvtColor(frame, gray_, cv::COLOR_BGR2GRAY);
+        cv::resize(gray_,
+                   small_,
+                   {},
+                   1. / GlobalVariables::noveltyDownscale,
+                   1. / GlobalVariables::noveltyDownscale,
+                   cv::INTER_AREA);
+
+        Utility::CharucoResults results{Utility::findBoard(charucoDetector_, small_, 0)};
+        if (results.charucoCorners.size() < GlobalVariables::noveltyMinCorners) return false;
+
+        ids_ = std::move(results.charucoIds);
+        corners_ = std::move(results.charucoCorners);
+        for (auto& corner : corners_) corner *= static_cast<float>(GlobalVariables::noveltyDownscale);
+
+        const auto uncovered{
+            std::ranges::count_if(corners_,
+                                  [this](const cv::Point2f& corner) {
+                                      return coverage_.countAt(corner) < 1.F;
+                                  })
+        };
+        const double coverageNovelty{static_cast<double>(uncovered) / static_cast<double>(corners_.size())};
+
+        return coverageNovelty >= minCoverage_ || minCapturedDisplacement() >= minDisplacement_;
+    }
+
+
+    void NoveltyTracker::accept() {
+        lastCapture_ = std::chrono::steady_clock::now();
+        if (corners_.empty()) return;
+
+        coverage_.add(corners_);
+        auto& view{captured_.emplace_back()};
+        for (std::size_t i{0}; i < ids_.size(); ++i) view.emplace(ids_[i], corners_[i]);
+    }
+
+
+    double NoveltyTracker::minCapturedDisplacement() const {
+        // Without enough shared corners the views can not be compared, such a view counts as novel.
+        double minDisplacement{1.};
+        for (const auto& view : captured_) {
+            double displacement{0.};
+            std::size_t shared{0};
+            for (std::size_t i{0}; i < ids_.size(); ++i) {
+                if (const auto it{view.find(ids_[i])}; it != view.end()) {
+                    displacement += cv::norm(corners_[i] - it->second);
+                    ++shared;
+                }
+            }
+            if (shared < GlobalVariables::noveltyMinCorners) continue;
+            minDisplacement = std::min(minDisplacement, displacement / static_cast<double>(shared) / diagonal_);
+        }
+        return minDisplacement;
+    }
+} // YACCP
@@ -0,0 +1,62 @@
+#ifndef YACCP_SRC_RECORDING_RECORDERS_NOVELTY_TRACKER_HPP
+#define YACCP_SRC_RECORDING_RECORDERS_NOVELTY_TRACKER_HPP
+#include "../coverage_map.hpp"
+
+#include "../../config/recording.hpp"
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/objdetect/charuco_detector.hpp>
+
+namespace YACCP {
+    /**
+     * @brief Decides from preview detections of the master camera whether a board view is worth capturing.
+     *
+     * The board is detected on a downscaled frame. A view is novel when enough of its corners lie in coverage cells
+     * no capture covered yet, or when it moved far enough from every captured view. The movement is the mean
+     * displacement of the shared corners relative to the image diagonal, a cheap stand-in for the pose that needs no
+     * intrinsics. Captures are at least the minimum spacing apart.
+     */
+    class NoveltyTracker {
+    public:
+        NoveltyTracker(const Config::RecordingConfig& config,
+                       cv::Size resolution,
+                       const cv::aruco::CharucoDetector& charucoDetector);
+
+        /**
+         * @brief Detect the board in a master frame.
+         *
+         * @return Whether the view is novel and the minimum spacing since the last capture passed.
+         */
+        [[nodiscard]] bool observe(const cv::Mat& frame);
+
+        /**
+         * @brief Register the last observed view as captured.
+         */
+        void accept();
+
+
+    private:
+        const cv::aruco::CharucoDetector& charucoDetector_;
+        double minCoverage_;
+        double minDisplacement_;
+        std::chrono::milliseconds minSpacing_;
+        double diagonal_;
+
+        CoverageMap coverage_;
+        std::vector<std::unordered_map<int, cv::Point2f> > captured_;
+        std::optional<std::chrono::steady_clock::time_point> lastCapture_;
+
+        cv::Mat gray_;
+        cv::Mat small_;
+        std::vector<int> ids_;
+        std::vector<cv::Point2f> corners_;
+
+        [[nodiscard]] double minCapturedDisplacement() const;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_RECORDERS_NOVELTY_TRACKER_HPP
@@ -1,14 +1,24 @@
 #include "prophesee_cam_worker.hpp"
 
+#include "../event_filter_chain.hpp"
 #include "../job_data.hpp"
+#include "../trigger_index.hpp"
+#include "event_rate_governor.hpp"
+#include "event_ring.hpp"
+#include "event_slicer.hpp"
+
+#include "../../global_variables/program_defaults.hpp"
+
+#include <optional>
+#include <utility>
+
+#include <readerwriterqueue.h>
 
 #include <metavision/hal/facilities/i_erc_module.h>
 #include <metavision/hal/facilities/i_event_trail_filter_module.h>
 #include <metavision/hal/facilities/i_hw_identification.h>
 #include <metavision/hal/facilities/i_ll_biases.h>
 #include <metavision/hal/facilities/i_trigger_in.h>
-#include <metavision/sdk/core/algorithms/on_demand_frame_generation_algorithm.h>
-#include <metavision/sdk/core/algorithms/polarity_filter_algorithm.h>
 #include <metavision/sdk/core/utils/cd_frame_generator.h>
 
 namespace YACCP {
@@ -186,9 +196,11 @@ namespace YACCP {
                                            Config::RecordingConfig& recordingConfig,
                                            Config::Prophesee& configBackend,
                                            int index,
-                                           const std::filesystem::path& jobPath) :
+                                           const std::filesystem::path& jobPath,
+                                           const cv::aruco::CharucoDetector& charucoDetector) :
         CameraWorker(stopSource, camDatas, recordingConfig, index, jobPath),
-        configBackend_(configBackend) {
+        configBackend_(configBackend),
+        charucoDetector_(charucoDetector) {
     }
 
 
@@ -253,18 +265,24 @@ namespace YACCP {
             cv::Mat cdFrame;
             std::mutex cd_frame_mutex;
             Metavision::timestamp cd_frame_ts{0};
-            // Set polarity filter to only include events with a positive polarity.
-            Metavision::PolarityFilterAlgorithm pol_filter{1};
             const auto& geometry = cam.geometry();
             camData_.info.resolution.width = geometry.get_width();
             camData_.info.resolution.height = geometry.get_height();
-            auto requestNew{true};
             auto requestedFrame{0};
             auto masterCamFrameIndex{0};
+            // Built alongside the event file, so it never has to be rebuilt by decoding the whole file.
+            TriggerIndex triggerIndex{configBackend_.fallingEdgePolarity};
+            std::uint64_t cdEvents{0};
 
-            // Configure facilities like biases en timing interfaces.
+            // Configure facilities like biases en timing interfaces, together with the software event filters.
+            // The polarity and blink representations need the OFF events as well.
+            std::optional<EventFilterChain> filterChain;
             try {
                 configureFacilities(cam);
+                filterChain.emplace(camData_.info.resolution,
+                                    configBackend_,
+                                    configBackend_.frameRepresentation == Config::FrameRepresentation::polarity ||
+                                    configBackend_.frameRepresentation == Config::FrameRepresentation::blink);
             }
             catch (...) {
                 camData_.runtimeData.e = std::current_exception();
@@ -275,10 +293,41 @@ namespace YACCP {
             Metavision::CDFrameGenerator cdFrameGenerator{geometry.get_width(), geometry.get_height()};
             cdFrameGenerator.set_display_accumulation_time_us(configBackend_.accumulationTime);
 
-            Metavision::OnDemandFrameGenerationAlgorithm onDemandFrameGenerator{
-                geometry.get_width(),
-                geometry.get_height(),
-                static_cast<uint32_t>(std::round(1e6 / static_cast<double>(recordingConfig_.fps)))
+            const auto triggerAccumulationTime{
+                static_cast<std::uint32_t>(std::round(1e6 / static_cast<double>(recordingConfig_.fps)))
+            };
+            EventSlicer slicer{camData_.info.resolution, configBackend_, triggerAccumulationTime, &charucoDetector_};
+
+            // Frames are only requested once per detection interval, so instead of accumulating every event the recent
+            // events are kept and only the window of a requested trigger is rendered. The slack covers CD buffers that
+            // are delivered after the trigger they precede, the retained window CD buffers delivered before it.
+            EventRing eventRing{slicer.maxWindow() + GlobalVariables::eventRingSlack};
+            eventRing.retainFrom(0);
+            std::optional<VerifyTask> pendingFrame;
+            Metavision::timestamp pendingTrigger{};
+            // The candidates are only rendered on the decoding thread, the board detection that selects one of them
+            // runs on this worker thread.
+            moodycamel::ReaderWriterQueue<std::pair<int, std::vector<cv::Mat> > > candidatesQ{4};
+            const auto generatePending{
+                [&eventRing, &slicer, &pendingFrame, &pendingTrigger, &candidatesQ](const bool force) {
+                    if (!pendingFrame || (!force && eventRing.newest() < pendingTrigger)) return;
+
+                    std::vector<cv::Mat> candidates;
+                    slicer.render(eventRing, pendingTrigger, candidates);
+
+                    (void)candidatesQ.enqueue({pendingFrame->id, std::move(candidates)});
+                    pendingFrame.reset();
+                }
+            };
+            const auto selectCandidates{
+                [this, &slicer, &candidatesQ] {
+                    std::pair<int, std::vector<cv::Mat> > candidates;
+                    while (candidatesQ.try_dequeue(candidates)) {
+                        const std::size_t best{slicer.select(candidates.second)};
+                        (void)camData_.runtimeData.frameVerifyQ.enqueue(
+                            {candidates.first, std::move(candidates.second[best])});
+                    }
+                }
             };
 
             (void)cdFrameGenerator.start(
@@ -290,55 +339,108 @@ namespace YACCP {
                 });
 
             (void)cam.ext_trigger().add_callback(
-                [this, &onDemandFrameGenerator, &requestNew, &requestedFrame, &masterCamFrameIndex](
+                [this, &requestedFrame, &masterCamFrameIndex, &triggerIndex, &cdEvents, &pendingFrame,
+                    &pendingTrigger, &generatePending, &eventRing, &slicer](
                 const Metavision::EventExtTrigger* begin,
                 const Metavision::EventExtTrigger* end) {
-                    if (requestNew) {
-                        (void)camData_.runtimeData.frameRequestQ.try_dequeue(requestedFrame);
-                        requestNew = false;
-                    }
+                    if (requestedFrame == 0) (void)camData_.runtimeData.frameRequestQ.try_dequeue(requestedFrame);
 
                     for (auto ev = begin; ev != end; ++ev) {
                         // Check for falling edge trigger and increment frame index.
                         if (ev->p == configBackend_.fallingEdgePolarity) {
                             // Handle falling edge trigger event
                             ++masterCamFrameIndex;
+                            triggerIndex.add(ev->t, cdEvents);
+                            // Later triggers are not earlier than this one, so their windows start after this one.
+                            eventRing.retainFrom(ev->t - slicer.maxWindow());
                         }
                         // TODO: Add warning when camera is not keeping up.
 
                         // If a frame was requested and the current frame index matches or
-                        // is larger than the requested frame, generate and enqueue it.
+                        // is larger than the requested frame, generate it once its events arrived.
                         if (masterCamFrameIndex >= requestedFrame && requestedFrame > 0) {
-                            VerifyTask task;
-                            task.id = requestedFrame;
-                            onDemandFrameGenerator.generate(ev->t, task.frame);
-                            (void)camData_.runtimeData.frameVerifyQ.enqueue(task);
-
-                            requestNew = true;
+                            // A frame that is still waiting for its events is generated with what arrived so far.
+                            generatePending(true);
+                            pendingFrame.emplace();
+                            pendingFrame->id = requestedFrame;
+                            pendingTrigger = ev->t;
+                            requestedFrame = 0;
+                            (void)camData_.runtimeData.frameRequestQ.try_dequeue(requestedFrame);
                         }
                     }
+                    generatePending(false);
                 });
 
+            std::optional<EventRateGovernor> governor;
+            if (configBackend_.governorEnabled) {
+                // The ERC drops events in the sensor, so it is only adjusted when the user already enabled it.
+                governor.emplace(std::chrono::milliseconds(configBackend_.governorMaxLag),
+                                 configBackend_.ercEnabled
+                                     ? cam.get_device().get_facility<Metavision::I_ErcModule>()
+                                     : nullptr,
+                                 configBackend_.ercRate
+                                     ? std::optional{static_cast<std::uint32_t>(*configBackend_.ercRate)}
+                                     : std::nullopt,
+                                 jobPath_ / GlobalVariables::governorLogFileName);
+            }
+
+            // Reused between callbacks to avoid an allocation per event buffer.
+            std::vector<Metavision::EventCD> previewEvents;
+            Metavision::timestamp rateStart{-1};
+            std::size_t rateEvents{0};
             (void)cam.cd().add_callback(
-                [&pol_filter, &cdFrameGenerator, &onDemandFrameGenerator](
+                [this, &filterChain, &cdFrameGenerator, &eventRing, &generatePending, &cdEvents, &governor,
+                    &previewEvents, &rateStart, &rateEvents](
                 const Metavision::EventCD* begin,
                 const Metavision::EventCD* end) {
-                    std::vector<Metavision::EventCD> polFilterOut;
-                    pol_filter.process_events(begin, end, std::back_inserter(polFilterOut));
-                    begin = polFilterOut.data();
-                    end = begin + polFilterOut.size();
+                    const auto callbackStart{std::chrono::steady_clock::now()};
+                    const auto events{static_cast<std::size_t>(end - begin)};
+                    cdEvents += events;
+                    if (events == 0) return;
+                    const Metavision::timestamp lastEventTime{(end - 1)->t};
+
+                    const auto filtered{filterChain->process(begin, end)};
+                    begin = filtered.data();
+                    end = begin + filtered.size();
+
+                    // Rate of the filtered events, so a configured ROI limits the motion measure to the board.
+                    if (rateStart < 0) rateStart = lastEventTime;
+                    rateEvents += filtered.size();
+                    if (lastEventTime - rateStart >= GlobalVariables::eventRateWindow) {
+                        camData_.runtimeData.eventRate.store(static_cast<double>(rateEvents) * 1e6 /
+                                                             static_cast<double>(lastEventTime - rateStart));
+                        rateStart = lastEventTime;
+                        rateEvents = 0;
+                    }
+
+                    // The trigger frames always receive every event, only the preview is decimated.
+                    eventRing.push(begin, end);
+                    generatePending(false);
+
+                    const std::size_t decimation{governor ? static_cast<std::size_t>(governor->decimation()) : 1};
+                    if (decimation == 1) {
+                        cdFrameGenerator.add_events(begin, end);
+                    } else {
+                        previewEvents.clear();
+                        for (std::size_t i{0}; i < static_cast<std::size_t>(end - begin); i += decimation) {
+                            previewEvents.emplace_back(begin[i]);
+                        }
+                        cdFrameGenerator.add_events(previewEvents.data(), previewEvents.data() + previewEvents.size());
+                    }
 
-                    cdFrameGenerator.add_events(begin, end);
-                    onDemandFrameGenerator.process_events(begin, end);
+                    if (governor)
+                        governor->update(lastEventTime, events, std::chrono::steady_clock::now() - callbackStart);
                 });
 
             // TODO: Make event file recording optional.
             (void)cam.start();
-            (void)cam.start_recording(jobPath_ / "event_file.raw");
+            (void)cam.start_recording(jobPath_ / GlobalVariables::eventFileName);
 
             // TODO: Add master mode.
             camData_.runtimeData.isRunning.store(cam.is_running());
             while (cam.is_running() && !stopToken_.stop_requested()) {
+                selectCandidates();
+
                 cv::Mat localFrame;
                 {
                     std::unique_lock<std::mutex> lock(cd_frame_mutex);
@@ -357,6 +459,18 @@ namespace YACCP {
 
             (void)cam.stop_recording();
             (void)cam.stop();
+            // The callbacks have stopped, a frame still waiting for its events gets what arrived.
+            generatePending(true);
+            selectCandidates();
+
+            try {
+                triggerIndex.write(jobPath_ / GlobalVariables::eventFileName);
+                filterChain->writeStats(jobPath_ / GlobalVariables::eventFilterStatsFileName);
+            }
+            catch (...) {
+                camData_.runtimeData.e = std::current_exception();
+                (void)stopSource_.request_stop();
+            }
         } else {
             stopSource_.request_stop();
         }
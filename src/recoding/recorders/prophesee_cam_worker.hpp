@@ -2,6 +2,8 @@
 #define YACCP_SRC_RECORDING_RECORDERS_PROPHESEE_CAM_WORKER_HPP
 #include <metavision/sdk/stream/camera.h>
 
+#include <opencv2/objdetect/charuco_detector.hpp>
+
 #include "camera_worker.hpp"
 
 
@@ -15,7 +17,8 @@ namespace YACCP {
                            Config::RecordingConfig& recordingConfig,
                            Config::Prophesee& configBackend,
                            int index,
-                           const std::filesystem::path& jobPath);
+                           const std::filesystem::path& jobPath,
+                           const cv::aruco::CharucoDetector& charucoDetector);
 
         static void listAvailableSources();
 
@@ -24,6 +27,8 @@ namespace YACCP {
 
     private:
         Config::Prophesee& configBackend_;
+        // Scores the candidate windows of the best frame slicing.
+        const cv::aruco::CharucoDetector& charucoDetector_;
 
         void configureBiases(Metavision::Device& device) const;
 
@@ -0,0 +1,128 @@
+#include "trigger_index.hpp"
+
+#include "../global_variables/program_defaults.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <metavision/sdk/stream/camera.h>
+
+namespace YACCP {
+    TriggerIndex::TriggerIndex(const int polarity) : polarity_(polarity) {
+    }
+
+
+    std::filesystem::path TriggerIndex::pathFor(const std::filesystem::path& eventFile) {
+        std::filesystem::path path{eventFile};
+        return path.replace_extension(GlobalVariables::triggerIndexExtension);
+    }
+
+
+    std::optional<TriggerIndex> TriggerIndex::load(const std::filesystem::path& eventFile, const int polarity) {
+        const std::filesystem::path path{pathFor(eventFile)};
+        std::ifstream file(path, std::ios::binary);
+        if (!file || !std::filesystem::exists(eventFile)) return std::nullopt;
+
+        TriggerIndexHeader header{};
+        (void)file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.magic != triggerIndexMagic || header.version != triggerIndexVersion ||
+            header.polarity != polarity || header.eventFileSize != std::filesystem::file_size(eventFile))
+            return std::nullopt;
+
+        // A truncated or corrupt sidecar is rebuilt instead of trusting its count.
+        const std::uintmax_t entryBytes{std::filesystem::file_size(path) - sizeof(header)};
+        if (header.count != entryBytes / sizeof(TriggerIndexEntry) || entryBytes % sizeof(TriggerIndexEntry) != 0)
+            return std::nullopt;
+
+        TriggerIndex index{polarity};
+        index.entries_.resize(header.count);
+        (void)file.read(reinterpret_cast<char*>(index.entries_.data()),
+                        static_cast<std::streamsize>(header.count * sizeof(TriggerIndexEntry)));
+        if (!file) return std::nullopt;
+
+        return index;
+    }
+
+
+    TriggerIndex TriggerIndex::build(const std::filesystem::path& eventFile, const int polarity) {
+        if (!std::filesystem::exists(eventFile))
+            throw std::runtime_error("Event file " + eventFile.string() + " does not exist");
+
+        // Decode as fast as possible instead of at the recorded rate.
+        Metavision::FileConfigHints hints;
+        (void)hints.real_time_playback(false);
+        Metavision::Camera cam{Metavision::Camera::from_file(eventFile.string(), hints)};
+
+        // Both callbacks are called from the decoding thread, so the counter needs no synchronisation.
+        TriggerIndex index{polarity};
+        std::uint64_t cdEvents{0};
+        (void)cam.cd().add_callback([&cdEvents](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            cdEvents += static_cast<std::uint64_t>(end - begin);
+        });
+        (void)cam.ext_trigger().add_callback(
+            [&index, &cdEvents, polarity](const Metavision::EventExtTrigger* begin,
+                                          const Metavision::EventExtTrigger* end) {
+                for (auto ev = begin; ev != end; ++ev) {
+                    if (ev->p == polarity) index.add(ev->t, cdEvents);
+                }
+            });
+
+        (void)cam.start();
+        while (cam.is_running()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        (void)cam.stop();
+
+        return index;
+    }
+
+
+    TriggerIndex TriggerIndex::loadOrBuild(const std::filesystem::path& eventFile, const int polarity) {
+        if (auto index{load(eventFile, polarity)}) return *index;
+
+        std::cout << "No trigger index found for " << eventFile.filename() << ", building it\n";
+        TriggerIndex index{build(eventFile, polarity)};
+        index.write(eventFile);
+        return index;
+    }
+
+
+    void TriggerIndex::write(const std::filesystem::path& eventFile) const {
+        TriggerIndexHeader header{};
+        header.magic = triggerIndexMagic;
+        header.version = triggerIndexVersion;
+        header.polarity = polarity_;
+        header.count = entries_.size();
+        header.eventFileSize = std::filesystem::file_size(eventFile);
+
+        const std::filesystem::path path{pathFor(eventFile)};
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Could not open " + path.string() + " for writing.");
+
+        (void)file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        (void)file.write(reinterpret_cast<const char*>(entries_.data()),
+                         static_cast<std::streamsize>(entries_.size() * sizeof(TriggerIndexEntry)));
+        if (!file) throw std::runtime_error("Failed writing trigger index " + path.string());
+    }
+
+
+    void TriggerIndex::add(const Metavision::timestamp t, const std::uint64_t eventsBefore) {
+        entries_.push_back({t, eventsBefore});
+    }
+
+
+    const std::vector<TriggerIndexEntry>& TriggerIndex::entries() const {
+        return entries_;
+    }
+
+
+    std::vector<Metavision::timestamp> TriggerIndex::timestamps() const {
+        std::vector<Metavision::timestamp> timestamps;
+        timestamps.reserve(entries_.size());
+        for (const auto& entry : entries_) timestamps.emplace_back(entry.t);
+        return timestamps;
+    }
+} // YACCP
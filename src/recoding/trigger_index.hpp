@@ -0,0 +1,89 @@
+#ifndef YACCP_SRC_RECORDING_TRIGGER_INDEX_HPP
+#define YACCP_SRC_RECORDING_TRIGGER_INDEX_HPP
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <metavision/sdk/base/utils/timestamp.h>
+
+namespace YACCP {
+    inline constexpr std::array<char, 8> triggerIndexMagic{'Y', 'A', 'C', 'C', 'P', 'T', 'R', 'G'};
+    inline constexpr std::uint32_t triggerIndexVersion{1};
+
+    /**
+     * @brief Trigger n of the recording, n being the frame index of the live recording minus one.
+     *
+     * @param t Timestamp of the trigger.
+     * @param eventsBefore Amount of CD events decoded before the trigger, the difference between two entries is the
+     * amount of events in between.
+     */
+    struct TriggerIndexEntry {
+        Metavision::timestamp t;
+        std::uint64_t eventsBefore;
+    };
+
+    /**
+     * @brief On-disk header of a trigger index, directly followed by count entries.
+     *
+     * The size of the event file is stored to detect an index that no longer belongs to its event file.
+     */
+    struct TriggerIndexHeader {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::int32_t polarity;
+        std::uint64_t count;
+        std::uint64_t eventFileSize;
+        std::array<std::uint8_t, 32> padding;
+    };
+
+    static_assert(sizeof(TriggerIndexHeader) == 64);
+    static_assert(sizeof(TriggerIndexEntry) == 16);
+
+    /**
+     * @brief Sidecar index of the external triggers in a recorded event file.
+     *
+     * Maps trigger number to timestamp and event count, so a window around any trigger is found without decoding the
+     * file. Decoding that window then only needs a seek to its timestamp.
+     */
+    class TriggerIndex {
+    public:
+        explicit TriggerIndex(int polarity);
+
+        [[nodiscard]] static std::filesystem::path pathFor(const std::filesystem::path& eventFile);
+
+        /**
+         * @brief Read the index next to the event file, when it exists and still matches the event file.
+         */
+        [[nodiscard]] static std::optional<TriggerIndex> load(const std::filesystem::path& eventFile, int polarity);
+
+        /**
+         * @brief Build the index by decoding the whole event file once.
+         */
+        [[nodiscard]] static TriggerIndex build(const std::filesystem::path& eventFile, int polarity);
+
+        /**
+         * @brief Load the index, or build and write it when it is missing or stale.
+         */
+        [[nodiscard]] static TriggerIndex loadOrBuild(const std::filesystem::path& eventFile, int polarity);
+
+        /**
+         * @brief Write the index next to the event file, the event file has to be complete.
+         */
+        void write(const std::filesystem::path& eventFile) const;
+
+        void add(Metavision::timestamp t, std::uint64_t eventsBefore);
+
+        [[nodiscard]] const std::vector<TriggerIndexEntry>& entries() const;
+
+        [[nodiscard]] std::vector<Metavision::timestamp> timestamps() const;
+
+
+    private:
+        int polarity_;
+        std::vector<TriggerIndexEntry> entries_;
+    };
+} // YACCP
+
+#endif //YACCP_SRC_RECORDING_TRIGGER_INDEX_HPP
@@ -1,8 +1,13 @@
 #include "video_viewer.hpp"
 
+#include "coverage_map.hpp"
 #include "job_data.hpp"
+#include "../detection/tracking_detector.hpp"
 #include "../utility.hpp"
 
+#include "../global_variables/program_defaults.hpp"
+
+#include <iomanip>
 #include <thread>
 
 #include <metavision/sdk/ui/utils/event_loop.h>
@@ -25,8 +30,9 @@ void printKeyMap() {
             A           Toggle between showing board detections on all or no cameras
             S           Turn detections on for the previous camera
             D           Turn detections on for the next camera
-            Z           Toggle recorded detections overlay
-            L           Clear recorded detections overlay
+            Z           Toggle coverage heatmap of the recorded detections
+            L           Clear coverage heatmap
+            U           Toggle undistortion of the live view, when started with --undistort-with
         )";
     std::cout << "\n\n";
 }
@@ -47,8 +53,11 @@ namespace YACCP {
                              std::vector<CamData>& camDatas,
                              const cv::aruco::CharucoDetector& charucoDetector,
                              moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ,
+                             moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ,
                              const std::filesystem::path& outputPath,
-                             float cornerMin)
+                             float cornerMin,
+                             const Config::DetectionConfig& detectionConfig,
+                             const std::vector<std::unique_ptr<Calibration::RemapTable> >& remapTables)
         : stopSource_(stopSource),
           stopToken_(stopSource.get_token()),
           viewsHorizontal_(viewsHorizontal),
@@ -57,20 +66,38 @@ namespace YACCP {
           camDatas_(camDatas),
           charucoDetector_(charucoDetector),
           valCornersQ_(valCornersQ),
+          estimateQ_(estimateQ),
           outputPath_(outputPath),
-          cornerMin_(cornerMin) {
+          cornerMin_(cornerMin),
+          detectionConfig_(detectionConfig),
+          remapTables_(remapTables) {
     }
 
 
     void VideoViewer::processFrame(std::stop_token stopToken,
                                    CamData& camData,
                                    const int camRef,
-                                   std::atomic<int>& camDetectMode) {
+                                   std::atomic<int>& camDetectMode,
+                                   std::atomic<bool>& undistortMode) {
+        const Calibration::RemapTable* remapTable{
+            remapTables_.empty() ? nullptr : remapTables_[camData.info.camIndexId].get()
+        };
+        cv::Mat rawFrame;
+        TrackingDetector trackingDetector{charucoDetector_, detectionConfig_};
+
         while (!stopToken.stop_requested()) {
             cv::Mat localFrame;
             {
                 std::unique_lock<std::mutex> lock(camData.runtimeData.m);
-                camData.runtimeData.frame.copyTo(localFrame);
+                camData.runtimeData.frame.copyTo(rawFrame);
+            }
+
+            // Tables of a camera with another resolution are ignored.
+            if (remapTable != nullptr && undistortMode.load(std::memory_order_relaxed) &&
+                rawFrame.size() == remapTable->size()) {
+                remapTable->apply(rawFrame, localFrame);
+            } else {
+                localFrame = rawFrame;
             }
 
             int mode = camDetectMode.load(std::memory_order_relaxed);
@@ -79,7 +106,7 @@ namespace YACCP {
                 cv::Mat grayFrame;
                 cv::cvtColor(localFrame, grayFrame, cv::COLOR_BGR2GRAY);
 
-                Utility::CharucoResults charucoResults{Utility::findBoard(charucoDetector_, grayFrame, 0)};
+                Utility::CharucoResults charucoResults{trackingDetector.findBoard(grayFrame, 0)};
 
                 if (!charucoResults.markerIds.empty())
                     cv::aruco::drawDetectedMarkers(
@@ -142,27 +169,78 @@ namespace YACCP {
     }
 
 
-    std::vector<cv::Point> VideoViewer::correctCoordinates(const ValidatedCornersData& validatedCornersData) {
-        cv::Point2f offset{
-            static_cast<float>(camDatas_[validatedCornersData.camId].info.viewData.windowX),
-            static_cast<float>(camDatas_[validatedCornersData.camId].info.viewData.windowY)
-        };
-        std::vector<cv::Point> correctedCorners;
+    void VideoViewer::drawEstimates(cv::Mat& display,
+                                    const std::vector<std::optional<CalibrationEstimate> >& estimates) const {
+        for (const auto& estimate : estimates) {
+            if (!estimate) continue;
+
+            const auto& viewData{camDatas_[estimate->camId].info.viewData};
+            // Green once the estimate has settled, orange while it is still moving.
+            const cv::Scalar colour{estimate->stable ? cv::Scalar(0., 255., 0.) : cv::Scalar(0., 165., 255.)};
 
-        for (const auto& corner : validatedCornersData.charucoCorners) {
-            correctedCorners.emplace_back(static_cast<cv::Point>(corner + offset));
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(3) << "RMS: " << estimate->reprojError << " px  delta: "
+                << std::setprecision(2) << estimate->parameterDelta * 100. << "%  views: " << estimate->views;
+
+            cv::putText(display,
+                        oss.str(),
+                        cv::Point(viewData.windowX + 10, viewData.windowY + 30),
+                        cv::FONT_HERSHEY_SIMPLEX,
+                        0.8,
+                        colour,
+                        2);
+        }
+    }
+
+
+    void VideoViewer::drawAcceptance(cv::Mat& display, const std::vector<std::vector<int> >& acceptance) const {
+        // The matrix sits in the bottom right corner with a header row and column of camera indexes.
+        const auto cams{static_cast<int>(acceptance.size())};
+        const int cell{GlobalVariables::acceptanceCellSize};
+        const cv::Point origin{display.cols - (cams + 1) * cell - 10, display.rows - (cams + 1) * cell - 10};
+        if (cams < 2 || origin.x < 0 || origin.y < 0) return;
+
+        const cv::Scalar white{255., 255., 255.};
+        cv::rectangle(display, cv::Rect(origin, cv::Size((cams + 1) * cell, (cams + 1) * cell)), {0., 0., 0.}, -1);
+        for (auto i{0}; i < cams; ++i) {
+            cv::putText(display,
+                        std::to_string(i),
+                        origin + cv::Point((i + 1) * cell + 4, cell - 12),
+                        cv::FONT_HERSHEY_SIMPLEX,
+                        0.6,
+                        white,
+                        1);
+            cv::putText(display,
+                        std::to_string(i),
+                        origin + cv::Point(4, (i + 2) * cell - 12),
+                        cv::FONT_HERSHEY_SIMPLEX,
+                        0.6,
+                        white,
+                        1);
+
+            for (auto j{0}; j < cams; ++j) {
+                cv::putText(display,
+                            std::to_string(acceptance[i][j]),
+                            origin + cv::Point((j + 1) * cell + 4, (i + 2) * cell - 12),
+                            cv::FONT_HERSHEY_SIMPLEX,
+                            0.6,
+                            getColourGradient(acceptance[i][j], 2 * GlobalVariables::acceptanceTargetViews),
+                            i == j ? 2 : 1);
+            }
         }
-        return correctedCorners;
     }
 
 
     void VideoViewer::start() {
         std::vector<int> camRefs;
         std::vector<std::jthread> threads;
-        std::vector<std::vector<cv::Point> > pts;
+        std::vector<CoverageMap> coverageMaps;
+        std::vector<std::optional<CalibrationEstimate> > estimates(camDatas_.size());
+        std::vector acceptance(camDatas_.size(), std::vector<int>(camDatas_.size()));
         std::atomic camDetectMode = -2;
         std::atomic detectLayerMode = true;
         std::atomic detectLayerClean = false;
+        std::atomic undistortMode = !remapTables_.empty();
         auto validatedImagePairs{0};
         auto validatedCorners{0};
         cv::Scalar textColour;
@@ -185,6 +263,7 @@ namespace YACCP {
 
             camDatas_[i].info.viewData.windowX = x;
             camDatas_[i].info.viewData.windowY = y;
+            coverageMaps.emplace_back(camDatas_[i].info.resolution, GlobalVariables::coverageCellSize);
 
             camRefs.emplace_back(frameComposer_.add_new_subimage_parameters(
                     x,
@@ -209,8 +288,6 @@ namespace YACCP {
 
         int width{(frameComposer_.get_total_width())};
         int height{(frameComposer_.get_total_height())};
-        cv::Mat overlay = cv::Mat::zeros(height, width, CV_8UC3);
-        cv::Mat mask = cv::Mat::zeros(height, width, CV_8UC1);
         cv::Mat display{height, width, CV_8UC3};
 
         Metavision::Window window("Recording board detections",
@@ -224,7 +301,8 @@ namespace YACCP {
                 &camDetectMode,
                 &camRefs,
                 &detectLayerMode,
-                &detectLayerClean
+                &detectLayerClean,
+                &undistortMode
             ](Metavision::UIKeyEvent key, int scancode, Metavision::UIAction action, int mods) {
                 int mode;
                 bool layerClean;
@@ -276,7 +354,7 @@ namespace YACCP {
                             detectLayerClean.store(true, std::memory_order_relaxed);
                             Utility::clearScreen();
                             printKeyMap();
-                            std::cout << "Cleaning detection overlay\n";
+                            std::cout << "Clearing coverage heatmap\n";
                         }
                         break;
                     case Metavision::UIKeyEvent::KEY_Z:
@@ -285,21 +363,28 @@ namespace YACCP {
                             detectLayerMode.store(true, std::memory_order_relaxed);
                             Utility::clearScreen();
                             printKeyMap();
-                            std::cout << "Enabling detection overlay mode\n";
+                            std::cout << "Enabling coverage heatmap\n";
                         } else {
                             detectLayerMode.store(false, std::memory_order_relaxed);
                             Utility::clearScreen();
                             printKeyMap();
-                            std::cout << "Disabling detection overlay mode\n";
+                            std::cout << "Disabling coverage heatmap\n";
                         }
+                        break;
+                    case Metavision::UIKeyEvent::KEY_U:
+                        if (remapTables_.empty()) break;
+                        undistortMode.store(!undistortMode.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        Utility::clearScreen();
+                        printKeyMap();
+                        std::cout << (undistortMode ? "Undistorting the live view\n" : "Showing the raw live view\n");
                     }
                 }
             });
 
         for (auto i{0}; i < static_cast<int>(camDatas_.size()); ++i) {
             threads.emplace_back(
-                [this, i, &camDetectMode, &camRefs](std::stop_token st) {
-                    processFrame(st, camDatas_[i], camRefs[i], camDetectMode);
+                [this, i, &camDetectMode, &camRefs, &undistortMode](std::stop_token st) {
+                    processFrame(st, camDatas_[i], camRefs[i], camDetectMode, undistortMode);
                 }
             );
         }
@@ -314,25 +399,37 @@ namespace YACCP {
             frame.copyTo(display);
 
             ValidatedCornersData validatedCornersData;
-            if (valCornersQ_.try_dequeue(validatedCornersData)) {
+            while (valCornersQ_.try_dequeue(validatedCornersData)) {
                 // Update the validated counts.
                 validatedImagePairs = validatedCornersData.validatedImagePair;
                 validatedCorners = validatedCornersData.validatedCorners;
+                acceptance = std::move(validatedCornersData.acceptance);
 
-                auto correctedCorners = correctCoordinates(validatedCornersData);
-                pts.clear();
-                pts.emplace_back(correctedCorners);
-                cv::polylines(overlay, pts, false, cv::Scalar{0., 255., 0.}, 2);
-                cv::polylines(mask, pts, false, cv::Scalar{255.}, 2);
+                coverageMaps[validatedCornersData.camId].add(validatedCornersData.charucoCorners);
+            }
+            CalibrationEstimate estimate;
+            while (estimateQ_.try_dequeue(estimate)) {
+                estimates[estimate.camId] = estimate;
             }
+
             if (layerClean) {
-                overlay.setTo(cv::Scalar{0., 0., 0.});
-                mask.setTo(cv::Scalar{0.});
+                for (auto& coverageMap : coverageMaps) {
+                    coverageMap.clear();
+                }
                 detectLayerClean.store(false, std::memory_order_relaxed);
             }
             if (layerMode) {
-                overlay.copyTo(display, mask);
+                for (auto i{0}; i < camDatas_.size(); ++i) {
+                    const auto& info{camDatas_[i].info};
+                    cv::Mat tile{display(cv::Rect(info.viewData.windowX,
+                                                  info.viewData.windowY,
+                                                  info.resolution.width,
+                                                  info.resolution.height))};
+                    coverageMaps[i].render(tile, GlobalVariables::coverageAlpha);
+                }
             }
+            drawEstimates(display, estimates);
+            drawAcceptance(display, acceptance);
 
             textColour = getColourGradient(validatedCorners, 960);
 
@@ -2,6 +2,12 @@
 #define YACCP_SRC_RECORDING_VIDEO_VIEWER_HPP
 #include "recorders/camera_worker.hpp"
 
+#include "../calibration/remap_table.hpp"
+#include "../config/detection.hpp"
+
+#include <memory>
+#include <optional>
+
 #include <readerwriterqueue.h>
 
 #include <metavision/sdk/core/utils/frame_composer.h>
@@ -10,10 +16,30 @@ namespace YACCP {
     struct ValidatedCornersData {
         int id;
         int camId;
+        // Charuco IDs belonging to charucoCorners of this camera.
         std::vector<int> charucoIds;
         std::vector<cv::Point2f> charucoCorners;
         int validatedImagePair;
         int validatedCorners;
+        // Accepted views per camera on the diagonal and per camera pair off the diagonal.
+        std::vector<std::vector<int> > acceptance;
+    };
+
+    /**
+     * @brief Intermediate intrinsic calibration result of a single camera, published by the CalibrationEstimator.
+     *
+     * @param camId Index of the camera this estimate belongs to.
+     * @param views Amount of views used for this estimate.
+     * @param reprojError RMS reprojection error in pixels.
+     * @param parameterDelta Largest relative change of fx, fy, cx and cy compared to the previous estimate.
+     * @param stable Whether the estimate changed less than the configured threshold.
+     */
+    struct CalibrationEstimate {
+        int camId;
+        int views;
+        double reprojError;
+        double parameterDelta;
+        bool stable;
     };
 
     class VideoViewer {
@@ -25,8 +51,11 @@ namespace YACCP {
                     std::vector<CamData>& camDatas,
                     const cv::aruco::CharucoDetector& charucoDetector,
                     moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ,
+                    moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ,
                     const std::filesystem::path& outputPath,
-                    float cornerMin);
+                    float cornerMin,
+                    const Config::DetectionConfig& detectionConfig,
+                    const std::vector<std::unique_ptr<Calibration::RemapTable> >& remapTables);
 
         void start();
 
@@ -41,16 +70,26 @@ namespace YACCP {
         std::vector<CamData>& camDatas_;
         const cv::aruco::CharucoDetector charucoDetector_;
         moodycamel::ReaderWriterQueue<ValidatedCornersData>& valCornersQ_;
+        moodycamel::ReaderWriterQueue<CalibrationEstimate>& estimateQ_;
         const std::filesystem::path& outputPath_;
         float cornerMin_;
+        Config::DetectionConfig detectionConfig_;
+        // Indexed by camera ID, empty when the live view is not undistorted.
+        const std::vector<std::unique_ptr<Calibration::RemapTable> >& remapTables_;
 
-        void processFrame(std::stop_token stopToken, CamData& camData, int camRef, std::atomic<int>& camDetectMode);
+        void processFrame(std::stop_token stopToken,
+                          CamData& camData,
+                          int camRef,
+                          std::atomic<int>& camDetectMode,
+                          std::atomic<bool>& undistortMode);
 
         [[nodiscard]] std::tuple<std::vector<int>, std::vector<int> > calculateBiggestDims() const;
 
         [[nodiscard]] std::tuple<int, int> calculateRowColumnIndex(int camIndex) const;
 
-        [[nodiscard]] std::vector<cv::Point> correctCoordinates(const ValidatedCornersData& validatedCornersData);
+        void drawEstimates(cv::Mat& display, const std::vector<std::optional<CalibrationEstimate> >& estimates) const;
+
+        void drawAcceptance(cv::Mat& display, const std::vector<std::vector<int> >& acceptance) const;
     };
 } // YACCP
 
@@ -3,14 +3,27 @@
 #include "../global_variables/config_defaults.hpp"
 #include "../global_variables/program_defaults.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/videoio.hpp>
 
 namespace {
-    void generateVideo(const cv::Mat& image, const cv::Size size, const std::filesystem::path& jobPath) {
+    void generateVideo(const cv::Mat& image,
+                       const cv::Size size,
+                       const double blinkFrequency,
+                       const std::filesystem::path& jobPath) {
         const std::string filename{(jobPath / YACCP::GlobalVariables::boardVideoFileName).string()};
 
+        // Every half period shows the same frame, the frame rate is adjusted to make the blink frequency exact.
+        const int halfPeriodFrames{
+            std::max(1, static_cast<int>(std::lround(YACCP::GlobalVariables::videoFps / (2 * blinkFrequency))))
+        };
+        const double fps{2 * blinkFrequency * halfPeriodFrames};
+
         // H264 codec seems to work on most devices
         const int codec{cv::VideoWriter::fourcc('h', '2', '6', '4')};
 
@@ -18,18 +31,20 @@ namespace {
         cv::cvtColor(image, imageBgr, cv::COLOR_GRAY2BGR);
 
         const cv::Mat blankImage{cv::Mat::zeros(size, CV_8UC3)};
-        cv::VideoWriter writer(filename, codec, static_cast<double>(YACCP::GlobalVariables::videoFps), size, true);
+        cv::VideoWriter writer(filename, codec, fps, size, true);
 
         if (!writer.isOpened()) {
             throw std::runtime_error("Could not open the output video for writing: " + filename + "\n");
         }
 
-        // Ten-second video.
-        for (auto i{0}; i < YACCP::GlobalVariables::videoFps * 5; i++) {
-            writer.write(imageBgr);
-            writer.write(blankImage);
+        const auto periods{std::lround(blinkFrequency * YACCP::GlobalVariables::boardVideoDuration)};
+        for (auto i{0L}; i < periods; i++) {
+            for (auto j{0}; j < halfPeriodFrames; j++) writer.write(imageBgr);
+            for (auto j{0}; j < halfPeriodFrames; j++) writer.write(blankImage);
         }
         writer.release();
+
+        std::cout << "Board video blinks at " << blinkFrequency << " Hz, written at " << fps << " fps\n";
     }
 }
 
@@ -98,7 +113,7 @@ namespace YACCP::CreateBoard {
         }
 
         if (boardCreationConfig.generateVideo) {
-            generateVideo(boardImage, imageSize, jobPath);
+            generateVideo(boardImage, imageSize, boardCreationConfig.blinkFrequency, jobPath);
         }
     }
 } // namespace YACCP
\ No newline at end of file
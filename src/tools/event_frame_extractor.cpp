@@ -0,0 +1,174 @@
+#include "event_frame_extractor.hpp"
+
+#include "../recoding/event_accumulator.hpp"
+#include "../recoding/event_filter_chain.hpp"
+#include "../recoding/recorders/event_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include <metavision/sdk/stream/camera.h>
+
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+namespace YACCP::EventFrameExtractor {
+    static Metavision::Camera openEventFile(const std::filesystem::path& eventFile) {
+        if (!std::filesystem::exists(eventFile))
+            throw std::runtime_error("Event file " + eventFile.string() + " does not exist");
+
+        // Decode as fast as possible instead of at the recorded rate.
+        Metavision::FileConfigHints hints;
+        (void)hints.real_time_playback(false);
+        return Metavision::Camera::from_file(eventFile.string(), hints);
+    }
+
+
+    static void waitUntilDone(Metavision::Camera& cam, const std::atomic<bool>& done) {
+        while (cam.is_running() && !done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        (void)cam.stop();
+    }
+
+
+    // Stream the events of a single trigger range and generate the frames of that range in order.
+    static void extractRange(const std::filesystem::path& eventFile,
+                             const std::filesystem::path& outPath,
+                             const std::vector<Metavision::timestamp>& triggers,
+                             const std::vector<int>& frames,
+                             const Config::Prophesee& config) {
+        Metavision::Camera cam{openEventFile(eventFile)};
+        const auto& geometry{cam.geometry()};
+        const cv::Size resolution{geometry.get_width(), geometry.get_height()};
+        const int accumulationTime{config.accumulationTime};
+
+        // The polarity and blink representations need the OFF events as well.
+        EventFilterChain filterChain{
+            resolution,
+            config,
+            config.frameRepresentation == Config::FrameRepresentation::polarity ||
+            config.frameRepresentation == Config::FrameRepresentation::blink
+        };
+        EventAccumulator accumulator{
+            resolution,
+            config.frameRepresentation,
+            static_cast<std::uint32_t>(accumulationTime),
+            config.timeSurfaceDecay,
+            config.blinkFrequency
+        };
+        EventRing eventRing{accumulationTime};
+
+        // The activity filter only keeps events supported within its threshold, streaming that much before the
+        // first window gives it the same history as the live filter had.
+        const Metavision::timestamp windowStart{
+            triggers[frames.front() - 1] - accumulationTime - std::max(config.activityThreshold, 0)
+        };
+        std::atomic<bool> seeked{windowStart <= 0};
+        std::atomic<bool> done{false};
+        std::size_t next{0};
+
+        const auto writeFrame{
+            [&] {
+                const Metavision::timestamp trigger{triggers[frames[next] - 1]};
+                cv::Mat frame;
+                accumulator.render(eventRing.window(trigger - accumulationTime, trigger), trigger, frame);
+                (void)cv::imwrite((outPath / ("frame_" + std::to_string(frames[next]) + ".png")).string(), frame);
+                ++next;
+            }
+        };
+
+        (void)cam.cd().add_callback(
+            [&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+                // Events decoded before the seek took effect belong to the start of the file.
+                if (!seeked.load() || done.load()) return;
+
+                const auto filtered{filterChain.process(begin, end)};
+                begin = filtered.data();
+                end = begin + filtered.size();
+
+                // Render every frame whose trigger lies within this buffer before adding the events after it.
+                while (next < frames.size()) {
+                    const auto* const split{
+                        std::lower_bound(begin,
+                                         end,
+                                         triggers[frames[next] - 1],
+                                         [](const Metavision::EventCD& ev, const Metavision::timestamp t) {
+                                             return ev.t < t;
+                                         })
+                    };
+                    eventRing.push(begin, split);
+                    begin = split;
+                    if (split == end) break;
+                    writeFrame();
+                }
+                eventRing.push(begin, end);
+
+                if (next == frames.size()) done.store(true);
+            });
+
+        (void)cam.start();
+        if (!seeked.load()) {
+            auto& control{cam.offline_streaming_control()};
+            // The seek index of the file is built in the background on first use.
+            while (!control.is_ready() && cam.is_running()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (!control.seek(std::max(windowStart, control.get_seek_start_time())))
+                throw std::runtime_error("Could not seek in event file " + eventFile.string());
+            seeked.store(true);
+        }
+        waitUntilDone(cam, done);
+
+        // The file ended before the last triggers, generate them from the events that were seen.
+        while (next < frames.size()) writeFrame();
+    }
+
+
+    void extractFrames(const std::filesystem::path& eventFile,
+                       const std::filesystem::path& outPath,
+                       const TriggerIndex& triggerIndex,
+                       std::vector<int> frames,
+                       const Config::Prophesee& config) {
+        const auto& entries{triggerIndex.entries()};
+        const auto triggers{triggerIndex.timestamps()};
+
+        std::ranges::sort(frames);
+        const auto [first, last] = std::ranges::unique(frames);
+        (void)frames.erase(first, last);
+        if (frames.empty()) throw std::runtime_error("No frames to extract");
+        if (frames.front() < 1 || frames.back() > static_cast<int>(triggers.size()))
+            throw std::runtime_error("Frame " + std::to_string(frames.back()) + " requested, but the event file only "
+                                     "contains " + std::to_string(triggers.size()) + " triggers");
+
+        (void)std::filesystem::create_directories(outPath);
+
+        // Contiguous trigger ranges keep the seeks small, the event counts of the index balance the ranges by the
+        // amount of events each has to stream instead of by the amount of frames.
+        const int ranges{std::min(cv::getNumThreads(), static_cast<int>(frames.size()))};
+        const std::uint64_t firstEvents{entries[frames.front() - 1].eventsBefore};
+        const std::uint64_t totalEvents{entries[frames.back() - 1].eventsBefore - firstEvents + 1};
+        std::vector<std::vector<int> > rangeFrames(ranges);
+        for (const int frame : frames) {
+            const std::uint64_t position{entries[frame - 1].eventsBefore - firstEvents};
+            rangeFrames[static_cast<std::size_t>(position * static_cast<std::uint64_t>(ranges) / totalEvents)].
+                emplace_back(frame);
+        }
+
+        cv::parallel_for_(cv::Range(0, ranges),
+                          [&](const cv::Range& range) {
+                              for (auto r{range.start}; r < range.end; ++r) {
+                                  if (rangeFrames[r].empty()) continue;
+                                  extractRange(eventFile,
+                                               outPath,
+                                               triggers,
+                                               rangeFrames[r],
+                                               config);
+                              }
+                          });
+
+        std::cout << "Extracted " << frames.size() << " frames in " << ranges << " trigger ranges\n";
+    }
+} // YACCP::EventFrameExtractor
@@ -0,0 +1,28 @@
+#ifndef YACCP_SRC_TOOLS_EVENT_FRAME_EXTRACTOR_HPP
+#define YACCP_SRC_TOOLS_EVENT_FRAME_EXTRACTOR_HPP
+#include "../config/recording.hpp"
+#include "../recoding/trigger_index.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace YACCP::EventFrameExtractor {
+    /**
+     * @brief Regenerate the frames at the given trigger indices from a recorded event file.
+     *
+     * The frames are split into contiguous trigger ranges holding about the same amount of events, every range streams
+     * its own part of the file on a separate thread after seeking to it. Frames are written as frame_<n>.png, the
+     * naming of the live recording.
+     *
+     * @param frames One-based frame indices into the trigger index.
+     * @param config Camera config the frames are rendered with, this sets the accumulation time, representation and
+     * software event filters.
+     */
+    void extractFrames(const std::filesystem::path& eventFile,
+                       const std::filesystem::path& outPath,
+                       const TriggerIndex& triggerIndex,
+                       std::vector<int> frames,
+                       const Config::Prophesee& config);
+} // YACCP::EventFrameExtractor
+
+#endif //YACCP_SRC_TOOLS_EVENT_FRAME_EXTRACTOR_HPP
@@ -13,10 +13,10 @@ namespace YACCP {
                                          const std::vector<std::filesystem::path>& cams,
                                          const std::vector<int>& camRefs) const {
         for (auto i{0}; i < cams.size(); ++i) {
-            frameComposer.update_subimage(
-                camRefs[i],
-                cv::imread(
-                    (jobPath_ / "images/raw" / cams[i] / files[currentFileIndex_]).string()));
+            cv::Mat image{cv::imread((jobPath_ / "images/raw" / cams[i] / files[currentFileIndex_]).string())};
+            // A set may only have been accepted for part of the cameras, the others are shown black.
+            if (image.empty()) image = cv::Mat::zeros(resolutions_[i], CV_8UC3);
+            frameComposer.update_subimage(camRefs[i], image);
         }
     }
 
@@ -91,12 +91,16 @@ namespace YACCP {
             }
             cams.push_back(entry.path().filename());
         }
-        for (auto const& entry : std::filesystem::directory_iterator(jobPath_ / "images" / "raw" / cams[0])) {
-            if (!entry.is_regular_file()) continue;
-            images.push_back(entry.path().filename());
+        for (const auto& cam : cams) {
+            for (auto const& entry : std::filesystem::directory_iterator(jobPath_ / "images" / "raw" / cam)) {
+                if (!entry.is_regular_file()) continue;
+                images.push_back(entry.path().filename());
+            }
         }
 
         std::ranges::sort(images);
+        const auto [first, last]{std::ranges::unique(images)};
+        (void)images.erase(first, last);
 
         nlohmann::json j = Utility::loadJobDataFromFile(jobPath_);
         j.at("config").get_to(fileConfig);
@@ -113,6 +117,7 @@ namespace YACCP {
             const int topLeftY = cam.viewData.windowY;
             const unsigned width = cam.resolution.width;
             const unsigned height = cam.resolution.height;
+            resolutions_.emplace_back(cam.resolution);
             camRefs.emplace_back(
                 frameComposer.add_new_subimage_parameters(topLeftX,
                                                           topLeftY,
@@ -253,6 +258,9 @@ namespace YACCP {
 
             // TODO: Change to direct vector indexing.
             for (auto j{0}; j < cams.size(); ++j) {
+                // Cameras the set was not accepted for have no image.
+                if (!std::filesystem::exists(jobPath_ / "images" / "raw" / cams[j] / images[i])) continue;
+
                 try {
                     std::filesystem::copy(jobPath_ / "images" / "raw" / cams[j] / images[i],
                                           jobPath_ / "images" / "verified" / cams[j] / images[i]
@@ -4,6 +4,8 @@
 
 #include <metavision/sdk/core/utils/frame_composer.h>
 
+#include <opencv2/core/types.hpp>
+
 
 namespace YACCP {
     class ImageValidator {
@@ -20,6 +22,8 @@ namespace YACCP {
         std::filesystem::path jobPath_;
         int currentFileIndex_{0};
         std::vector<int> indexesToDiscard_;
+        // Per subimage, in the order of the camera references.
+        std::vector<cv::Size> resolutions_;
 
         void updateSubimages(Metavision::FrameComposer& frameComposer,
                              const std::vector<std::filesystem::path>& files,
@@ -10,6 +10,17 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/objdetect/aruco_detector.hpp>
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 
 namespace YACCP::Utility {
     void clearScreen() {
@@ -21,6 +32,16 @@ namespace YACCP::Utility {
     }
 
 
+    void lowerThreadPriority() {
+#if defined(_WIN32)
+        (void)SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+        // On Linux the nice value is per thread when addressed by its thread ID.
+        (void)setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    }
+
+
     // MISRA deviation: OpenCV Charuco API requires std::vector
     CharucoResults findBoard(const cv::aruco::CharucoDetector& charucoDetector,
                              const cv::Mat& gray,
@@ -73,6 +73,12 @@ namespace YACCP::Utility {
 
     void clearScreen();
 
+    /**
+     * @brief Lower the scheduling priority of the calling thread, used for background work that should never compete
+     * with the camera and detection threads.
+     */
+    void lowerThreadPriority();
+
     [[nodiscard]] CharucoResults findBoard(const cv::aruco::CharucoDetector& charucoDetector,
                                            const cv::Mat& gray,
                                            int cornerMin);
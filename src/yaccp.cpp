@@ -7,6 +7,7 @@
 
 #include "executors/board_runner.hpp"
 #include "executors/calibration_runner.hpp"
+#include "executors/extraction_runner.hpp"
 #include "executors/recording_runner.hpp"
 #include "executors/validation_runner.hpp"
 
@@ -75,6 +76,13 @@ int main(int argc, char** argv) {
                 err) {
                 std::cerr << err.what() << "\n";
             }
+        } else if (*cliCmds.extractionCmd) {
+            try {
+                exitCode = YACCP::Executor::runExtraction(cliCmdConfig, path);
+            }
+            catch (const std::exception& err) {
+                std::cerr << err.what() << "\n";
+            }
         } else {
             std::cerr << "No valid sub command given\n";
         }